@@ -0,0 +1,108 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+
+/**
+********************************************************************************
+*
+*   @file       BufferPool.h
+*
+*   @brief      Class to recycle the pixel buffers of the images.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstddef> // Header file for size_t
+
+
+//==============================================================================
+/**
+*   @class  BufferPool
+*   @brief  BufferPool keeps the released pixel buffers and hands them out
+*           again, so images of the same size (e.g. the frames of a stream
+*           and the temporary images of the filters) do not go through the
+*           system allocator and do not page-fault fresh memory. Sizes are
+*           rounded up to size classes (at most 25% larger). Every thread
+*           keeps a few buffers of every class without locking; the other
+*           buffers are shared by the threads.
+*/
+//==============================================================================
+class BufferPool
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Usage of the pool since the start (or since resetStatistics)
+    struct Statistics
+    {
+        unsigned long long m_hit_count;     ///< allocations served by a cached buffer
+        unsigned long long m_miss_count;    ///< allocations served by the system
+        std::size_t m_used_bytes;           ///< bytes of the buffers in use
+        std::size_t m_cached_bytes;         ///< bytes of the buffers kept for later
+        std::size_t m_peak_bytes;           ///< largest number of bytes held (in use + kept)
+    };
+
+
+    //------------------------------------------------------------------------
+    /// Get a buffer. Its content is undefined.
+    /**
+    * @param aSize: the number of floats
+    * @return the buffer (to release with the same size)
+    */
+    //------------------------------------------------------------------------
+    static float* allocate(std::size_t aSize);
+
+
+    //------------------------------------------------------------------------
+    /// Give a buffer back to the pool. It is kept for a later allocation
+    /// unless the cache is full.
+    /**
+    * @param apBuffer: the buffer (can be NULL)
+    * @param aSize: the size passed to allocate
+    */
+    //------------------------------------------------------------------------
+    static void release(float* apBuffer, std::size_t aSize);
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on the usage of the pool
+    /**
+    * @return the statistics
+    */
+    //------------------------------------------------------------------------
+    static Statistics getStatistics();
+
+
+    //------------------------------------------------------------------------
+    /// Reset the hit and miss counts, and the peak to the current usage
+    //------------------------------------------------------------------------
+    static void resetStatistics();
+
+
+    //------------------------------------------------------------------------
+    /// Set the number of bytes kept in the cache shared by the threads
+    /**
+    * @param aByteCount: the limit (256 MB by default)
+    */
+    //------------------------------------------------------------------------
+    static void setCacheLimit(std::size_t aByteCount);
+
+
+    //------------------------------------------------------------------------
+    /// Give the buffers of the shared cache and of the cache of the calling
+    /// thread back to the system
+    //------------------------------------------------------------------------
+    static void clear();
+};
+
+#endif
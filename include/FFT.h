@@ -0,0 +1,148 @@
+#ifndef FFT_H
+#define FFT_H
+
+
+/**
+********************************************************************************
+*
+*   @file       FFT.h
+*
+*   @brief      Class to compute fast Fourier transforms of square tiles.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <complex>
+#include <vector>
+
+
+//==============================================================================
+/**
+*   @class  FFT
+*   @brief  FFT computes the discrete Fourier transform of 1D signals and of
+*           square 2D tiles whose size is a power of two (iterative radix-2
+*           Cooley-Tukey algorithm). The twiddle factors are precomputed.
+*/
+//==============================================================================
+class FFT
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Type of a sample
+    typedef std::complex<double> Complex;
+
+
+    //------------------------------------------------------------------------
+    /// Constructor.
+    /**
+    * @param aSize: the number of samples of a transform (power of two)
+    */
+    //------------------------------------------------------------------------
+    FFT(unsigned int aSize);
+
+
+    //------------------------------------------------------------------------
+    /// Number of samples of a transform
+    /**
+    * @return the size
+    */
+    //------------------------------------------------------------------------
+    unsigned int getSize() const;
+
+
+    //------------------------------------------------------------------------
+    /// Smallest power of two greater than or equal to aValue
+    /**
+    * @param aValue: the value
+    * @return the power of two
+    */
+    //------------------------------------------------------------------------
+    static unsigned int getPowerOfTwo(unsigned int aValue);
+
+
+    //------------------------------------------------------------------------
+    /// In-place forward transform of a 1D signal
+    /**
+    * @param apData: the getSize() samples, separated by aStride
+    * @param aStride: the distance between two samples
+    */
+    //------------------------------------------------------------------------
+    void forward(Complex* apData, unsigned int aStride = 1) const;
+
+
+    //------------------------------------------------------------------------
+    /// In-place inverse transform of a 1D signal (scaled by 1 / getSize())
+    /**
+    * @param apData: the getSize() samples, separated by aStride
+    * @param aStride: the distance between two samples
+    */
+    //------------------------------------------------------------------------
+    void inverse(Complex* apData, unsigned int aStride = 1) const;
+
+
+    //------------------------------------------------------------------------
+    /// In-place forward transform of a getSize() x getSize() tile
+    /**
+    * @param apData: the samples in row-major order
+    */
+    //------------------------------------------------------------------------
+    void forward2D(Complex* apData) const;
+
+
+    //------------------------------------------------------------------------
+    /// In-place inverse transform of a getSize() x getSize() tile
+    /// (scaled by 1 / getSize()^2)
+    /**
+    * @param apData: the samples in row-major order
+    */
+    //------------------------------------------------------------------------
+    void inverse2D(Complex* apData) const;
+
+
+//******************************************************************************
+private:
+    //------------------------------------------------------------------------
+    /// In-place transform without scaling
+    /**
+    * @param apData: the getSize() samples, separated by aStride
+    * @param aStride: the distance between two samples
+    * @param anInverseFlag: true for the inverse transform
+    */
+    //------------------------------------------------------------------------
+    void transform(Complex* apData, unsigned int aStride, bool anInverseFlag) const;
+
+
+    //------------------------------------------------------------------------
+    /// In-place 2D transform without scaling
+    /**
+    * @param apData: the samples in row-major order
+    * @param anInverseFlag: true for the inverse transform
+    */
+    //------------------------------------------------------------------------
+    void transform2D(Complex* apData, bool anInverseFlag) const;
+
+
+    /// Number of samples of a transform
+    unsigned int m_size;
+
+
+    /// exp(-2 i pi k / m_size) for k in [0, m_size / 2)
+    std::vector<Complex> m_twiddle_set;
+
+
+    /// Bit-reversed index of every sample
+    std::vector<unsigned int> m_reversed_index_set;
+};
+
+#endif
@@ -25,19 +25,1099 @@
 //  Include
 //******************************************************************************
 #include <string>
+#include <vector>
+
+#include "ImageExpression.h"
+
+
+//******************************************************************************
+//  Class declaration
+//******************************************************************************
+class ThreadPool;
+class Image;
+template<typename T> class PixelImage;
+
+
+//==============================================================================
+/**
+*   @class  ImageView
+*   @brief  ImageView describes greyscale pixels that it does not own: a
+*           pointer, a width, a height and a row stride. A region of an
+*           image is a view of the same pixels, so regions and tiles are
+*           processed without being copied. The filters and statistics are
+*           provided by ImageView and apply to an Image as well as to any
+*           view. A view must not outlive the pixels it refers to.
+*/
+//==============================================================================
+class ImageView
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //--------------------------------------------------------------------------
+    /// Default constructor (empty view).
+    //--------------------------------------------------------------------------
+    ImageView();
+
+
+    //------------------------------------------------------------------------
+    /// Constructor. The pixels are only read through the view.
+    /**
+    * @param apData: the first pixel
+    * @param aWidth: the number of pixels along the horizontal axis
+    * @param aHeight: the number of pixels along the vertical axis
+    * @param aStride: the distance between two rows (in number of pixels),
+    *                 0 if the rows are contiguous
+    */
+    //------------------------------------------------------------------------
+    ImageView(const float* apData,
+            unsigned int aWidth,
+            unsigned int aHeight,
+            unsigned int aStride = 0);
+
+
+    //------------------------------------------------------------------------
+    /// Copy constructor. The copy does not use the halo: only the image
+    /// that owns the pixels knows when they are modified.
+    /**
+    * @param anImage: the view to copy
+    */
+    //------------------------------------------------------------------------
+    ImageView(const ImageView& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator. The view does not use the halo (see above).
+    /**
+    * @param anImage: the view to copy
+    * @return the updated view
+    */
+    //------------------------------------------------------------------------
+    ImageView& operator=(const ImageView& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// View of a region of interest (ROI). Nothing is copied.
+    /**
+    * @param i: the position of the first pixel of the ROI along the horizontal axis
+    * @param j: the position of the first pixel of the ROI along the vertical axis
+    * @param aWidth: the width of the ROI (in number of pixels)
+    * @param aHeight: the height of the ROI (in number of pixels)
+    * @return the view of the ROI
+    */
+    //------------------------------------------------------------------------
+    ImageView getView(unsigned int i,
+            unsigned int j,
+            unsigned int aWidth,
+            unsigned int aHeight) const;
+
+
+    //------------------------------------------------------------------------
+    /// Distance between two rows
+    /**
+    * @return the stride (in number of pixels)
+    */
+    //------------------------------------------------------------------------
+    unsigned int getStride() const;
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on the pixels of a row
+    /**
+    * @param j: the position of the row along the vertical axis
+    * @return the first pixel of the row
+    */
+    //------------------------------------------------------------------------
+    const float* getRow(unsigned int j) const;
+
+
+    //------------------------------------------------------------------------
+    /// Check if two views share pixels
+    /**
+    * @param anImage: the other view
+    * @return true if a pixel of one view may be a pixel of the other one
+    */
+    //------------------------------------------------------------------------
+    bool isOverlapping(const ImageView& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Copy a region of interest (ROI). Pixels outside of the current
+    /// view are black.
+    /**
+    * @param i: the position of the first pixel of the ROI along the horizontal axis
+    * @param j: the position of the first pixel of the ROI along the vertical axis
+    * @param aWidth: the width of the ROI (in number of pixels)
+    * @param aHeight: the height of the ROI (in number of pixels)
+    * @return the ROI
+    */
+    //------------------------------------------------------------------------
+    Image getROI(unsigned int i,
+            unsigned int j,
+            unsigned int aWidth,
+            unsigned int aHeight) const;
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on a pixel value.
+    /**
+    * @param i: the position of the pixel along the horizontal axis
+    * @param j: the position of the pixel along the vertical axis
+    * @return the pixel value
+    */
+    //------------------------------------------------------------------------
+    float getPixel(unsigned int i, unsigned int j) const;
+
+    //------------------------------------------------------------------------
+    /// Compute the negative of the current image into an existing image.
+    /// The buffer of anOutput is reused if it has the right number of
+    /// pixels (no allocation). anOutput can be the current image.
+    /**
+    * @param anOutput: receives the negative image
+    */
+    //------------------------------------------------------------------------
+    void invert(Image& anOutput) const;
+
+    //------------------------------------------------------------------------
+    /// Compute the aspect ratio
+    /**
+    * @return the aspect ratio
+    */
+    //------------------------------------------------------------------------
+    float getAspectRatio() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of pixels along the horizontal axis
+    /**
+    * @return the width
+    */
+    //------------------------------------------------------------------------
+    unsigned int getWidth() const;
+    
+
+    //------------------------------------------------------------------------
+    /// Number of pixels along the vertical axis
+    /**
+    * @return the height
+    */
+    //------------------------------------------------------------------------
+    unsigned int getHeight() const;
+    
+
+    //------------------------------------------------------------------------
+    /// Compute the minimum pixel value in the image
+    /**
+    * @return the minimum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMinValue() const;
+    
+
+    //------------------------------------------------------------------------
+    /// Compute the maximum pixel value in the image
+    /**
+    * @return the maximum pixel
+    */
+    //------------------------------------------------------------------------
+    float getMaxValue() const;
+    
+
+    //------------------------------------------------------------------------
+    /// Operator Equal to
+    /**
+    * @param anImage: the image to compare with
+    * @return true if the images are similar,
+    *         false if they are different
+    */
+    //------------------------------------------------------------------------
+    bool operator==(const ImageView& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Operator Not equal to
+    /**
+    * @param anImage: the image to compare with
+    * @return true if the images are different,
+    *         false if they are similar
+    */
+    //------------------------------------------------------------------------
+	bool operator!=(const ImageView& anImage) const;
+	/*Operators*/
+
+
+	//------------------------------------------------------------------------
+	/// How pixels outside of the image are read by the filters
+	//------------------------------------------------------------------------
+	enum BorderMode
+	{
+		BORDER_REPLICATE,					///< repeat the closest edge pixel
+		BORDER_CLAMP = BORDER_REPLICATE,	///< same as BORDER_REPLICATE
+		BORDER_REFLECT,						///< mirror about the edge pixel
+		BORDER_CONSTANT						///< use a constant value
+	};
+
+
+	//------------------------------------------------------------------------
+	/// The functionalities of selectFunction_3x3
+	//------------------------------------------------------------------------
+	enum FunctionId
+	{
+		MEDIAN_FILTER = 0,
+		LAPLACIAN_FILTER = 1,
+		GAUSSIAN_BLUR = 2,
+		BOX_BLUR = 3,
+		SHARPEN_FILTER = 4,
+		PREWITT_FILTER = 5,
+		SOBEL_FILTER = 6
+	};
+
+
+	//------------------------------------------------------------------------
+	/// The implementations of convolve
+	//------------------------------------------------------------------------
+	enum ConvolutionMethod
+	{
+		CONVOLUTION_AUTO,		///< the fastest method for the kernel
+		CONVOLUTION_DIRECT,		///< one multiply-add per kernel weight
+		CONVOLUTION_SEPARABLE,	///< two 1D passes (rank-1 kernels only)
+		CONVOLUTION_FFT			///< products of spectra of overlapping tiles
+	};
+
+
+	//------------------------------------------------------------------------
+	/// The norms of a gradient
+	//------------------------------------------------------------------------
+	enum GradientNorm
+	{
+		GRADIENT_L1,	///< |gx| + |gy|
+		GRADIENT_L2		///< sqrt(gx^2 + gy^2)
+	};
+
+
+	//------------------------------------------------------------------------
+	/// The 3x3 gradient operators (derivatives are not normalised)
+	//------------------------------------------------------------------------
+	enum GradientOperator
+	{
+		GRADIENT_PREWITT,	///< derivative smoothed by [1 1 1]
+		GRADIENT_SOBEL,		///< derivative smoothed by [1 2 1]
+		GRADIENT_SCHARR,	///< derivative smoothed by [3 10 3]
+		GRADIENT_ROBERTS	///< differences along the diagonals of a 2x2 cross
+	};
+
+
+	//------------------------------------------------------------------------
+	/// Statistics of the pixels (see computeStats)
+	//------------------------------------------------------------------------
+	struct Statistics
+	{
+		float m_min_value;				///< the smallest pixel
+		float m_max_value;				///< the largest pixel
+		float m_mean;					///< the average
+		float m_variance;				///< the variance (of the population)
+		float m_standard_deviation;		///< the square root of the variance
+	};
+
+
+	//------------------------------------------------------------------------
+	/// Differences between two images (see compare)
+	//------------------------------------------------------------------------
+	struct Comparison
+	{
+		double m_sae;	///< sum of the absolute errors
+		double m_ssd;	///< sum of the squared differences
+		double m_mse;	///< mean squared error
+		double m_psnr;	///< peak signal-to-noise ratio in dB (infinite if the images are identical)
+		double m_ncc;	///< normalised cross-correlation in [-1, 1] (0 if an image is constant)
+	};
+
+
+	//------------------------------------------------------------------------
+	/// Select function and creates kernel
+	/**
+	* The interior of the image is processed without any bound check,
+	* the one-pixel border ring is processed in a separate pass using
+	* aBorderMode, unless the halo of the image holds the border (see
+	* Image::fillHalo).
+	*
+	* @param aFunctionID: the functionality selected (see FunctionId)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return a manipulated Image
+	*/
+	//------------------------------------------------------------------------
+	Image selectFunction_3x3(int aFunctionId,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Same as selectFunction_3x3, but the result is written into an
+	/// existing image. Its buffer is reused if it has the right number of
+	/// pixels, so a loop processing frames of the same size does not
+	/// allocate any memory.
+	/**
+	* @param aFunctionID: the functionality selected (see FunctionId)
+	* @param anOutput: receives the manipulated image
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	*/
+	//------------------------------------------------------------------------
+	void selectFunction_3x3(int aFunctionId,
+		Image& anOutput,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Convolve the image with any kernel. The kernel is applied as it is
+	/// (it is not flipped). With CONVOLUTION_AUTO, rank-1 kernels (outer
+	/// product of a column and a row) are detected and processed in two 1D
+	/// passes, other kernels are processed directly or, when it is expected
+	/// to be faster (large kernels), with FFTs of overlapping tiles. The
+	/// other methods force the implementation (CONVOLUTION_SEPARABLE throws
+	/// if the kernel is not rank-1).
+	/**
+	* @param aKernel: the weights in row-major order
+	* @param aKernelWidth: the number of columns of the kernel (odd)
+	* @param aKernelHeight: the number of rows of the kernel (odd)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @param aMethod: the implementation to use
+	* @return the filtered image
+	*/
+	//------------------------------------------------------------------------
+	Image convolve(const std::vector<float>& aKernel,
+		unsigned int aKernelWidth,
+		unsigned int aKernelHeight,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0,
+		ConvolutionMethod aMethod = CONVOLUTION_AUTO) const;
+
+
+	//------------------------------------------------------------------------
+	/// Convolve the image with a separable kernel, i.e. the outer product of
+	/// a vertical and a horizontal 1D kernel. The image is processed in two
+	/// passes (rows then columns), so the cost per pixel is proportional to
+	/// the sum of the kernel sizes instead of their product. The kernels are
+	/// applied as they are (they are not flipped).
+	/**
+	* @param aHorizontalKernel: the 1D kernel applied along the rows (odd size)
+	* @param aVerticalKernel: the 1D kernel applied along the columns (odd size)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the filtered image
+	*/
+	//------------------------------------------------------------------------
+	Image convolveSeparable(const std::vector<float>& aHorizontalKernel,
+		const std::vector<float>& aVerticalKernel,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Box blur of any radius, i.e. the average of the (2r+1)x(2r+1) pixels
+	/// around every pixel. Running sums are updated along the rows then
+	/// along the columns, so the cost per pixel does not depend on the radius.
+	/**
+	* @param aRadius: the radius of the box (0 returns a copy)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the blurred image
+	*/
+	//------------------------------------------------------------------------
+	Image boxBlur(unsigned int aRadius,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Median filter of any radius, i.e. the median of the (2r+1)x(2r+1)
+	/// pixels around every pixel. For 8-bit data (integer values in
+	/// [0, 255]) a histogram is kept for every column and slid along the
+	/// rows, so the cost per pixel does not depend on the radius. Other
+	/// data fall back to a partial sort of every neighbourhood.
+	/**
+	* @param aRadius: the radius of the window (0 returns a copy)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the filtered image
+	*/
+	//------------------------------------------------------------------------
+	Image medianFilter(unsigned int aRadius,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Gradient in a single pass: both derivatives are computed once per
+	/// pixel, then turned into the magnitude and, optionally, the direction,
+	/// so edge-based stages do not need to recompute them.
+	/**
+	* @param anOperator: the gradient operator
+	* @param aNorm: the norm of the magnitude
+	* @param apDirection: if not NULL, receives the direction of the
+	*                     gradient, atan2(gy, gx) in radians in [-pi, pi]
+	*                     (x towards the right, y towards the bottom)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the magnitude of the gradient
+	*/
+	//------------------------------------------------------------------------
+	Image gradient(GradientOperator anOperator,
+		GradientNorm aNorm = GRADIENT_L2,
+		Image* apDirection = 0,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Gradients of several operators in a single pass. The row and column
+	/// derivatives of every neighbourhood are loaded and computed once and
+	/// shared by the operators, so several edge maps of the same image cost
+	/// little more than one.
+	/**
+	* @param anOperatorSet: the gradient operators
+	* @param aMagnitudeSet: receives the magnitude of every operator
+	*                       (the images it holds are reused if possible)
+	* @param apDirectionSet: if not NULL, receives the direction of every
+	*                        operator (see gradient)
+	* @param aNorm: the norm of the magnitudes
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	*/
+	//------------------------------------------------------------------------
+	void gradients(const std::vector<GradientOperator>& anOperatorSet,
+		std::vector<Image>& aMagnitudeSet,
+		std::vector<Image>* apDirectionSet = 0,
+		GradientNorm aNorm = GRADIENT_L2,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Sobel gradient, same as gradient(GRADIENT_SOBEL, ...)
+	/**
+	* @param aNorm: the norm of the magnitude
+	* @param apDirection: if not NULL, receives the direction of the gradient
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the magnitude of the gradient
+	*/
+	//------------------------------------------------------------------------
+	Image sobelGradient(GradientNorm aNorm = GRADIENT_L2,
+		Image* apDirection = 0,
+		BorderMode aBorderMode = BORDER_REPLICATE,
+		float aBorderValue = 0) const;
+
+
+	//------------------------------------------------------------------------
+	/// Set the number of threads used by the filters. The image is split
+	/// into horizontal bands processed in parallel; the output is identical
+	/// to the single-threaded one. Do not call while a filter is running.
+	/**
+	* @param aNumberOfThreads: the number of threads, 0 to use every
+	*                          hardware thread, 1 (default) to run serially
+	*/
+	//------------------------------------------------------------------------
+	static void setNumberOfThreads(unsigned int aNumberOfThreads);
+
+
+	//------------------------------------------------------------------------
+	/// Number of threads used by the filters
+	/**
+	* @return the number of threads
+	*/
+	//------------------------------------------------------------------------
+	static unsigned int getNumberOfThreads();
+
+
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+	//								Statistics:
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+
+
+	//------------------------------------------------------------------------
+	/// Compute SAE, SSD, MSE, PSNR and NCC in a single fused pass over the
+	/// two images: every row is processed with SIMD instructions (see
+	/// RowKernels::compare) and its sums are accumulated in double
+	/// precision. The rows are shared by the threads (see
+	/// setNumberOfThreads) and their sums are added in order, so the
+	/// result does not depend on the number of threads. Nothing is printed.
+	/**
+	* @param anImage: the image to compare with (same size)
+	* @param aPeakValue: the largest possible pixel value, for the PSNR
+	* @return the metrics
+	*/
+	//------------------------------------------------------------------------
+	Comparison compare(const ImageView& anImage, float aPeakValue = 255) const;
+
+
+	//------------------------------------------------------------------------
+	/// Sum of All Errors (see compare)
+	/**
+	* @param anImage: the image to compare with
+	* @return the sum of the absolute differences, 0 if the images
+	*         have different sizes
+	*/
+	//------------------------------------------------------------------------
+	float getSAE(const ImageView& anImage) const;
+
+	//------------------------------------------------------------------------
+	/// Normalized Cross Correlation (see compare)
+	/**
+	* @param anImage: the image to compare with
+	* @return the correlation in [-1, 1] (1 if the images are similar),
+	*         0 if the images have different sizes
+	*/
+	//------------------------------------------------------------------------
+	float getNCC(const ImageView& anImage) const;
+
+
+	//------------------------------------------------------------------------
+	/// Prints a histogram (see getHistogram)
+	/**
+	* @param aNumberOfBins: the number of bins
+	* @return 0
+	*/
+	//------------------------------------------------------------------------
+	float createHistogram(const int aNumberOfBins) const;
+
+
+	//------------------------------------------------------------------------
+	/// Histogram of the pixels between the minimum and the maximum pixel
+	/// values. Every pixel is counted in a single pass, the last bin
+	/// includes the maximum. With several threads (see setNumberOfThreads)
+	/// every thread counts a band of rows in private bins, and the bins
+	/// are added at the end: the result does not depend on the number of
+	/// threads.
+	/**
+	* @param aNumberOfBins: the number of bins
+	* @return the number of pixels in every bin
+	*/
+	//------------------------------------------------------------------------
+	std::vector<unsigned int> getHistogram(unsigned int aNumberOfBins) const;
+
+
+	//------------------------------------------------------------------------
+	/// Histogram of the pixels in a given range, e.g. to compare the
+	/// histograms of several images. The bins have a width of
+	/// (aMaxValue - aMinValue) / aNumberOfBins, the last bin includes
+	/// aMaxValue and the pixels outside of the range are not counted.
+	/**
+	* @param aNumberOfBins: the number of bins
+	* @param aMinValue: the lower bound of the first bin
+	* @param aMaxValue: the upper bound of the last bin
+	* @return the number of pixels in every bin
+	*/
+	//------------------------------------------------------------------------
+	std::vector<unsigned int> getHistogram(unsigned int aNumberOfBins,
+			float aMinValue,
+			float aMaxValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Histogram of 8-bit data (e.g. a loaded PGM file) with 256 bins: bin
+	/// k counts the pixels that round to k, the values are clamped to
+	/// [0, 255]. No minimum or maximum is needed. Computed in parallel as
+	/// getHistogram.
+	/**
+	* @return the number of pixels of every value
+	*/
+	//------------------------------------------------------------------------
+	std::vector<unsigned int> get8BitHistogram() const;
+
+
+	//------------------------------------------------------------------------
+	/// Writes the histogram to a file
+	/**
+	* @param aNumberOfBins: number of bins selected
+	* @param aFIleName: name of the file
+	*/
+	//------------------------------------------------------------------------
+	void writeHistogram(unsigned int aNumberOfBins, const std::string& aFileName) const;
+
+	//------------------------------------------------------------------------
+	/// Writes the histogram to a file
+	/**
+	* @param aNumberOfBins: number of bins selected
+	* @param aFIleName: name of the file
+	*/
+	//------------------------------------------------------------------------
+	void writeHistogram(unsigned int aNumberOfBins, const char * aFileName) const;
+	
+	//------------------------------------------------------------------------
+	/// Compute the minimum, the maximum, the mean, the variance and the
+	/// standard deviation in a single vectorised pass over the pixels. The
+	/// sums are accumulated in double precision, row by row, on the pixels
+	/// minus the first pixel, so the variance stays accurate for large
+	/// images with a large mean.
+	/**
+	* @return the statistics
+	*/
+	//------------------------------------------------------------------------
+	Statistics computeStats() const;
+
+
+	//------------------------------------------------------------------------
+	/// Gets the average
+	/**
+	* @return an average
+	*/
+	//------------------------------------------------------------------------
+	float getAverage() const;
+
+	//------------------------------------------------------------------------
+	/// Gets the variance
+	/**
+	* @return: the variance
+	*/
+	//------------------------------------------------------------------------
+	float getVariance() const;
+
+	//------------------------------------------------------------------------
+	/// Get the standard deviation
+	/**
+	* @return the standard deviation
+	*/
+	//------------------------------------------------------------------------
+
+
+	float getStandardDeviation() const;
+
+	/*Statistics.*/
+
+
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+	//								Filters:
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+
+
+	/// Applies median filter
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float filter_Median(float n0, float n1, float n2, float n3, float n4, 
+		float n5, float n6, float n7, float n8);
+
+	/// Applies a laplacian edge detector
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float filter_Laplacian(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+
+	/// Applies a Prewitt edge detector
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float filter_Prewitt(float n0, float n1, float n2, float n3,
+		float n4, float n5, float n6, float n7, float n8);
+
+	///Applies the Sobel Edge Detector
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float filter_Sobel(float n0, float n1, float n2, float n3,
+		float n4, float n5, float n6, float n7, float n8);
+	/*Filters.*/
+
+
+	//------------------------------------------------------------------------
+	//							Sharpen & Blur
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+	
+	///Applies box blur to an image
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float blur_Box(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+	
+	///Applies a Gaussian blur
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float blur_Gaussian(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+	
+	///Applies a sharpening filter
+	/**
+	* @param n0-n8: pixel values passed in
+	* @return aPixelValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	float sharpenImg(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+
+	//------------------------------------------------------------------------
+	//							Blend & Segnebt
+	//------------------------------------------------------------------------
+	//------------------------------------------------------------------------
+
+	//------------------------------------------------------------------------
+	/// Blends two images.
+	/**
+	* @param the image to be blended with
+	* @param the ratio the image will appear in
+	* @return a new image with both images blended
+	*/
+	//------------------------------------------------------------------------
+	Image blendImage(const ImageView& anImage, float blendRatio) const;
+
+
+	//------------------------------------------------------------------------
+	/// Blends two images into an existing image (its buffer is reused if
+	/// it has the right number of pixels). anOutput can be either input.
+	/**
+	* @param the image to be blended with
+	* @param the ratio the image will appear in
+	* @param anOutput: receives both images blended
+	*/
+	//------------------------------------------------------------------------
+	void blendImage(const ImageView& anImage, float blendRatio, Image& anOutput) const;
+
+
+	//------------------------------------------------------------------------
+	/// Segments an image
+	/**				
+	* @param the blending threshold
+	* @return the image with threshold applied
+	*/
+	//------------------------------------------------------------------------
+	Image segmentImage(const float threshold) const;
+
+
+	//------------------------------------------------------------------------
+	/// Segments an image into an existing image (its buffer is reused if
+	/// it has the right number of pixels). anOutput can be the current image.
+	/**
+	* @param the blending threshold
+	* @param anOutput: receives the image with threshold applied
+	*/
+	//------------------------------------------------------------------------
+	void segmentImage(const float threshold, Image& anOutput) const;
+
+
+
+
+
+//******************************************************************************
+private:
+	//------------------------------------------------------------------------
+	/// Copy a row and extend it by aRadius pixels on both sides
+	/**
+	* @param apRow: the row to copy
+	* @param aWidth: the number of pixels in the row
+	* @param aRadius: the number of pixels to add on each side
+	* @param aBorderMode: how to read the pixels outside of the row
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @param apOutput: the extended row (aWidth + 2 * aRadius pixels)
+	*/
+	//------------------------------------------------------------------------
+	static void extendRow(const float* apRow,
+		unsigned int aWidth,
+		unsigned int aRadius,
+		BorderMode aBorderMode,
+		float aBorderValue,
+		float* apOutput);
+
+
+	//------------------------------------------------------------------------
+	/// Decompose a kernel into the outer product of a column and a row
+	/**
+	* @param aKernel: the weights in row-major order
+	* @param aKernelWidth: the number of columns of the kernel
+	* @param aKernelHeight: the number of rows of the kernel
+	* @param aHorizontalKernel: the row (output)
+	* @param aVerticalKernel: the column (output)
+	* @return true if the kernel is separable, false otherwise
+	*/
+	//------------------------------------------------------------------------
+	static bool getSeparableKernels(const std::vector<float>& aKernel,
+		unsigned int aKernelWidth,
+		unsigned int aKernelHeight,
+		std::vector<float>& aHorizontalKernel,
+		std::vector<float>& aVerticalKernel);
+
+
+	//------------------------------------------------------------------------
+	/// Convolve the image with any kernel, one multiply-add per weight
+	/**
+	* @param aKernel: the weights in row-major order
+	* @param aKernelWidth: the number of columns of the kernel (odd)
+	* @param aKernelHeight: the number of rows of the kernel (odd)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the filtered image
+	*/
+	//------------------------------------------------------------------------
+	Image convolveDirect(const std::vector<float>& aKernel,
+		unsigned int aKernelWidth,
+		unsigned int aKernelHeight,
+		BorderMode aBorderMode,
+		float aBorderValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Convolve the image with any kernel using FFTs: the image (extended by
+	/// the border) is cut into tiles, every tile is multiplied by the kernel
+	/// in the frequency domain and the overlapping results are added
+	/// (overlap-add).
+	/**
+	* @param aKernel: the weights in row-major order
+	* @param aKernelWidth: the number of columns of the kernel (odd)
+	* @param aKernelHeight: the number of rows of the kernel (odd)
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the filtered image
+	*/
+	//------------------------------------------------------------------------
+	Image convolveFFT(const std::vector<float>& aKernel,
+		unsigned int aKernelWidth,
+		unsigned int aKernelHeight,
+		BorderMode aBorderMode,
+		float aBorderValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Tile size of convolveFFT that minimises the number of operations
+	/**
+	* @param aKernelWidth: the number of columns of the kernel
+	* @param aKernelHeight: the number of rows of the kernel
+	* @param aCost: the estimated number of operations (output)
+	* @return the size of the (square) tiles
+	*/
+	//------------------------------------------------------------------------
+	unsigned int getFFTTileSize(unsigned int aKernelWidth,
+		unsigned int aKernelHeight,
+		double& aCost) const;
+
+
+	//------------------------------------------------------------------------
+	/// Check if every pixel is an integer in [0, 255]
+	/**
+	* @return true if the image holds 8-bit data, false otherwise
+	*/
+	//------------------------------------------------------------------------
+	bool is8Bit() const;
+
+
+	//------------------------------------------------------------------------
+	/// Accessor on the worker threads shared by the filters
+	/**
+	* @return the thread pool
+	*/
+	//------------------------------------------------------------------------
+	static ThreadPool& getThreadPool();
+
+
+	//------------------------------------------------------------------------
+	/// Check if the pixels around the view are in memory, as the filters
+	/// would read them (see Image::fillHalo). The rows can then be read
+	/// past their ends without any bound check.
+	/**
+	* @param aRadius: the number of pixels needed on each side
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return true if the halo holds the border, false otherwise
+	*/
+	//------------------------------------------------------------------------
+	bool hasHalo(unsigned int aRadius, BorderMode aBorderMode, float aBorderValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Minimum and maximum pixel values, computed by every thread on its
+	/// band (see setNumberOfThreads)
+	/**
+	* @param aMinValue: receives the minimum
+	* @param aMaxValue: receives the maximum
+	*/
+	//------------------------------------------------------------------------
+	void computeRange(float& aMinValue, float& aMaxValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Count the pixels of the rows [aFirstRow, aLastRow) in a single pass.
+	/// Consecutive pixels go to 4 sub-histograms, so a run of identical
+	/// pixels does not wait for the previous increment of the same counter
+	/// (store-to-load forwarding); the sub-histograms are then added.
+	/**
+	* @param aFirstRow: the first row to process
+	* @param aLastRow: the row after the last one to process
+	* @param aNumberOfBins: the number of bins
+	* @param aMinValue: the lower bound of the first bin
+	* @param aMaxValue: the upper bound of the last bin
+	* @param apHistogram: the aNumberOfBins counts to increase
+	*/
+	//------------------------------------------------------------------------
+	void accumulateHistogram(unsigned int aFirstRow,
+			unsigned int aLastRow,
+			unsigned int aNumberOfBins,
+			float aMinValue,
+			float aMaxValue,
+			unsigned int* apHistogram) const;
+
+
+	//------------------------------------------------------------------------
+	/// Count the pixels of the rows [aFirstRow, aLastRow) in 256 bins (see
+	/// get8BitHistogram), with 4 sub-histograms.
+	/**
+	* @param aFirstRow: the first row to process
+	* @param aLastRow: the row after the last one to process
+	* @param apHistogram: the 256 counts to increase
+	*/
+	//------------------------------------------------------------------------
+	void accumulate8BitHistogram(unsigned int aFirstRow,
+			unsigned int aLastRow,
+			unsigned int* apHistogram) const;
+
+
+	//------------------------------------------------------------------------
+	/// Apply a 3x3 kernel on the rows [aFirstRow, aLastRow) of the interior
+	/// of the image (the first and last rows/columns are skipped)
+	/**
+	* @param anOutput: the image to write (same size as the current image)
+	* @param aRowKernel: the function processing a row of pixels
+	* @param aFirstRow: the first row to process
+	* @param aLastRow: the row after the last row to process
+	*/
+	//------------------------------------------------------------------------
+	template<typename RowKernel> void filterInterior_3x3(Image& anOutput,
+		RowKernel aRowKernel,
+		unsigned int aFirstRow,
+		unsigned int aLastRow) const;
+
+
+	//------------------------------------------------------------------------
+	/// Apply a 3x3 kernel on the one-pixel border ring of the image
+	/**
+	* @param anOutput: the image to write (same size as the current image)
+	* @param aKernel: the per-pixel function to apply
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	*/
+	//------------------------------------------------------------------------
+	template<typename Kernel> void filterBorder_3x3(Image& anOutput,
+		Kernel aKernel,
+		BorderMode aBorderMode,
+		float aBorderValue) const;
+
+
+	//------------------------------------------------------------------------
+	/// Apply a 3x3 kernel on every pixel of the image (in a single pass if
+	/// the halo holds the border)
+	/**
+	* @param anOutput: the image to write (same size as the current image)
+	* @param aKernel: the per-pixel function to apply on the border
+	* @param aRowKernel: the function processing a row of the interior
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	*/
+	//------------------------------------------------------------------------
+	template<typename Kernel, typename RowKernel> void apply_3x3(Image& anOutput,
+		Kernel aKernel,
+		RowKernel aRowKernel,
+		BorderMode aBorderMode,
+		float aBorderValue) const;
+
+
+//******************************************************************************
+protected:
+	//------------------------------------------------------------------------
+	/// Map a coordinate that may be outside of [0, aSize) back into the image
+	/**
+	* @param anIndex: the coordinate to map
+	* @param aSize: the number of pixels along the axis
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @return the mapped coordinate (BORDER_CONSTANT is mapped as BORDER_REPLICATE)
+	*/
+	//------------------------------------------------------------------------
+	static int getBorderIndex(int anIndex, int aSize, BorderMode aBorderMode);
+
+
+	//------------------------------------------------------------------------
+	/// Accessor on a pixel value that accepts coordinates outside of the image
+	/**
+	* @param i: the position of the pixel along the horizontal axis
+	* @param j: the position of the pixel along the vertical axis
+	* @param aBorderMode: how to read the pixels outside of the image
+	* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+	* @return the pixel value
+	*/
+	//------------------------------------------------------------------------
+	float getBorderPixel(int i, int j, BorderMode aBorderMode, float aBorderValue) const;
+
+
+    /// Number of pixel along the horizontal axis
+    unsigned int m_width;
+
+
+    /// Number of pixel along the vertical axis
+    unsigned int m_height;
+
+
+    /// Number of pixels between the first pixels of two rows
+    unsigned int m_stride;
+
+
+    /// The pixel data
+    float* m_p_image;
+
+
+    /// Number of pixels around the view that hold the border (0 if the
+    /// halo is not filled)
+    unsigned int m_halo_size;
+
+
+    /// How the pixels of the halo were computed
+    BorderMode m_halo_mode;
+
+
+    /// The pixel value of the halo with BORDER_CONSTANT
+    float m_halo_value;
+};
 
 
 //==============================================================================
 /**
 *   @class  Image
-*   @brief  Image is a class to manage a greyscale image.
+*   @brief  Image is a class to manage a greyscale image. It owns its
+*           pixels; the filters and statistics are inherited from
+*           ImageView. The rows are contiguous by default, or aligned on
+*           cache lines and surrounded by a halo (see setAlignedStorage).
 */
 //==============================================================================
-class Image
+class Image: public ImageView
 //------------------------------------------------------------------------------
 {
 //******************************************************************************
 public:
+    //------------------------------------------------------------------------
+    /// The encodings of savePGM
+    //------------------------------------------------------------------------
+    enum PGMFormat
+    {
+        PGM_ASCII,      ///< P2, the pixels are truncated to [0, 255] and printed
+        PGM_BINARY_8,   ///< P5, one byte per pixel (rounded to [0, 255])
+        PGM_BINARY_16   ///< P5, rounded to [0, 65535], two bytes per pixel (most significant first) if a pixel is above 255
+    };
+
+
     //--------------------------------------------------------------------------
     /// Default constructor.
     //--------------------------------------------------------------------------
@@ -51,6 +1131,25 @@ public:
     */
     //------------------------------------------------------------------------
     Image(const Image& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Constructor from a view, e.g. of a region of interest. The pixels
+    /// are copied.
+    /**
+    * @param anImage: the view to copy
+    */
+    //------------------------------------------------------------------------
+    explicit Image(const ImageView& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Move constructor: the pixels of anImage are transferred, not copied.
+    /**
+    * @param anImage: the image to move (it becomes empty)
+    */
+    //------------------------------------------------------------------------
+    Image(Image&& anImage) noexcept;
     
     
     //------------------------------------------------------------------------
@@ -91,132 +1190,179 @@ public:
     */
     //------------------------------------------------------------------------
     Image& operator=(const Image& anImage);
-    
-    
-    //------------------------------------------------------------------------
-    /// Release the memory.
-    //------------------------------------------------------------------------
-    void destroy();
-    
-    
+
+
     //------------------------------------------------------------------------
-    /// Compute a region of interest (ROI).
+    /// Move assignment operator: the pixels of anImage are transferred,
+    /// not copied.
     /**
-    * @param i: the position of the first pixel of the ROI along the horizontal axis
-    * @param j: the position of the first pixel of the ROI along the vertical axis
-    * @param aWidth: the width of the ROI (in number of pixels)
-    * @param aHeight: the height of the ROI (in number of pixels)
-    * @return the ROI
+    * @param anImage: the image to move (it becomes empty)
+    * @return the updated version of the current image
     */
     //------------------------------------------------------------------------
-    Image getROI(unsigned int i,
-            unsigned int j,
-            unsigned int aWidth,
-            unsigned int aHeight) const;
+    Image& operator=(Image&& anImage) noexcept;
 
 
     //------------------------------------------------------------------------
-    /// Accessor on a pixel value.
+    /// Constructor from an expression, e.g. Image c(a * 0.5f + b * 0.5f).
+    /// Every pixel is computed in a single loop.
     /**
-    * @param i: the position of the pixel along the horizontal axis
-    * @param j: the position of the pixel along the vertical axis
-    * @return the pixel value
+    * @param anExpression: the expression to evaluate
     */
     //------------------------------------------------------------------------
-    float getPixel(unsigned int i, unsigned int j) const;
+    template<typename Left, typename Right, typename Operation>
+    Image(const BinaryExpression<Left, Right, Operation>& anExpression);
 
 
-	//------------------------------------------------------------------------
-	/// Set a pixel.
-	/**
-	* @param i: the position of the pixel along the horizontal axis
-	* @param j: the position of the pixel along the vertical axis					//change this
-	* @param aValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	void setPixel(unsigned int i, unsigned int j, float aValue);
-	//------------------------------------------------------------------------
-    
     //------------------------------------------------------------------------
-    /// Addition operator. Add anImage
+    /// Constructor from an expression, e.g. Image c(a * 2.0f).
     /**
-    * @param anImage: the image to add
-    * @return the resulting image
+    * @param anExpression: the expression to evaluate
     */
     //------------------------------------------------------------------------
-    Image operator+(const Image& anImage);
-    
-    
+    template<typename Operand, typename Operation>
+    Image(const ScalarExpression<Operand, Operation>& anExpression);
+
+
     //------------------------------------------------------------------------
-    /// Subtraction operator. Add anImage
+    /// Assignment of an expression, e.g. c = a + b - 1.0f. The buffer is
+    /// reused when the number of pixels does not change, and the expression
+    /// may refer to the current image.
     /**
-    * @param anImage: the image to subtract
-    * @return the resulting image
+    * @param anExpression: the expression to evaluate
+    * @return the updated version of the current image
     */
     //------------------------------------------------------------------------
-    Image operator-(const Image& anImage);
+    template<typename Left, typename Right, typename Operation>
+    Image& operator=(const BinaryExpression<Left, Right, Operation>& anExpression);
 
 
     //------------------------------------------------------------------------
-    /// Addition assignment operator. Add anImage
+    /// Assignment of an expression (see above).
     /**
-    * @param anImage: the image to add
+    * @param anExpression: the expression to evaluate
     * @return the updated version of the current image
     */
     //------------------------------------------------------------------------
-    Image& operator+=(const Image& anImage);
+    template<typename Operand, typename Operation>
+    Image& operator=(const ScalarExpression<Operand, Operation>& anExpression);
 
 
     //------------------------------------------------------------------------
-    /// Subraction assignment operator. Add anImage
+    /// Exchange the pixels of two images without copying them.
     /**
-    * @param anImage: the image to subtract
-    * @return the updated version of the current image
+    * @param anImage: the image to exchange with
     */
     //------------------------------------------------------------------------
-    Image& operator-=(const Image& anImage);
+    void swap(Image& anImage) noexcept;
     
     
     //------------------------------------------------------------------------
-    /// Addition operator. Add aValue to every pixel of the image
+    /// Release the memory.
+    //------------------------------------------------------------------------
+    void destroy();
+
+
+    //------------------------------------------------------------------------
+    /// Store every row on its own 64-byte cache lines: the buffer is
+    /// aligned and the stride is a multiple of 16 pixels, so SIMD loads
+    /// and stores of the rows are aligned. Optionally, aHaloSize pixels
+    /// are kept around the image; once filled by fillHalo, the filters
+    /// read them instead of handling the border. The pixels are kept, and
+    /// the storage is kept when the image is resized.
     /**
-    * @param aValue: the value to add
-    * @return the resulting image
+    * @param aHaloSize: the number of pixels on each side of the image
+    */
+    //------------------------------------------------------------------------
+    void setAlignedStorage(unsigned int aHaloSize = 0);
+
+
+    //------------------------------------------------------------------------
+    /// Store the rows contiguously (default). The pixels are kept.
+    //------------------------------------------------------------------------
+    void setPackedStorage();
+
+
+    //------------------------------------------------------------------------
+    /// Check how the rows are stored
+    /**
+    * @return true if the rows are aligned (see setAlignedStorage),
+    *         false if they are contiguous
+    */
+    //------------------------------------------------------------------------
+    bool isAligned() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of pixels kept around the image
+    /**
+    * @return the size of the halo (see setAlignedStorage)
     */
     //------------------------------------------------------------------------
-    Image operator+(float aValue);
+    unsigned int getHaloSize() const;
 
 
     //------------------------------------------------------------------------
-    /// Subtraction operator. Subtract aValue to every pixel of the image
+    /// Compute the pixels of the halo as the filters read the pixels outside
+    /// of the image. Until the image is modified, the filters using the same
+    /// border mode (and radius up to the size of the halo) process every
+    /// pixel without bound check.
     /**
-    * @param aValue: the value to subtract
-    * @return the resulting image
+    * @param aBorderMode: how to read the pixels outside of the image
+    * @param aBorderValue: the pixel value used with BORDER_CONSTANT
     */
     //------------------------------------------------------------------------
-    Image operator-(float aValue);
+    void fillHalo(BorderMode aBorderMode = BORDER_REPLICATE, float aBorderValue = 0);
 
 
     //------------------------------------------------------------------------
-    /// Multiplication operator. Multiply every pixel of the image by aValue
+    /// Accessor on the pixels of a row. The pixels may be modified through
+    /// the pointer, so the halo is invalidated (call fillHalo again after
+    /// the modifications).
     /**
-    * @param aValue: the value for the multiplication
-    * @return the resulting image
+    * @param j: the position of the row along the vertical axis
+    * @return the first pixel of the row
     */
     //------------------------------------------------------------------------
-    Image operator*(float aValue);
+    float* getRow(unsigned int j);
+    using ImageView::getRow;
     
     
+
+	//------------------------------------------------------------------------
+	/// Set a pixel.
+	/**
+	* @param i: the position of the pixel along the horizontal axis
+	* @param j: the position of the pixel along the vertical axis					//change this
+	* @param aValue: the new pixel value
+	*/
+	//------------------------------------------------------------------------
+	void setPixel(unsigned int i, unsigned int j, float aValue);
+	//------------------------------------------------------------------------
+    
     //------------------------------------------------------------------------
-    /// Division operator. Divide every pixel of the image by aValue
+    /// Addition assignment operator. Add anImage in place (vectorised, no
+    /// allocation when anImage is at least as large as the current image).
+    /// As with operator+, only the area common to both images is kept.
     /**
-    * @param aValue: the value for the division
-    * @return the resulting image
+    * @param anImage: the image to add
+    * @return the updated version of the current image
     */
     //------------------------------------------------------------------------
-    Image operator/(float aValue);
+    Image& operator+=(const ImageView& anImage);
 
 
+    //------------------------------------------------------------------------
+    /// Subraction assignment operator. Subtract anImage in place (see
+    /// operator+=).
+    /**
+    * @param anImage: the image to subtract
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    Image& operator-=(const ImageView& anImage);
+    
+    
     //------------------------------------------------------------------------
     /// Addition operator. Add aValue to every pixel of the image
     /**
@@ -265,50 +1411,6 @@ public:
     //------------------------------------------------------------------------
     Image operator!();
 
-    //------------------------------------------------------------------------
-    /// Compute the aspect ratio
-    /**
-    * @return the aspect ratio
-    */
-    //------------------------------------------------------------------------
-    float getAspectRatio() const;
-
-
-    //------------------------------------------------------------------------
-    /// Number of pixels along the horizontal axis
-    /**
-    * @return the width
-    */
-    //------------------------------------------------------------------------
-    unsigned int getWidth() const;
-    
-
-    //------------------------------------------------------------------------
-    /// Number of pixels along the vertical axis
-    /**
-    * @return the height
-    */
-    //------------------------------------------------------------------------
-    unsigned int getHeight() const;
-    
-
-    //------------------------------------------------------------------------
-    /// Compute the minimum pixel value in the image
-    /**
-    * @return the minimum pixel
-    */
-    //------------------------------------------------------------------------
-    float getMinValue() const;
-    
-
-    //------------------------------------------------------------------------
-    /// Compute the maximum pixel value in the image
-    /**
-    * @return the maximum pixel
-    */
-    //------------------------------------------------------------------------
-    float getMaxValue() const;
-    
 
     //------------------------------------------------------------------------
     /// Add aShiftValue to every pixel, then multiply every pixel
@@ -346,21 +1448,25 @@ public:
     
     
     //------------------------------------------------------------------------
-    /// Save the image in a PGM file
+    /// Save the image in a PGM file. The binary formats convert the pixels
+    /// with SIMD instructions and write them at once (see Image8 and
+    /// Image16); they are much faster and smaller than PGM_ASCII.
     /**
     * @param aFileName: the name of the file to write
+    * @param aFormat: the encoding of the pixels
     */
     //------------------------------------------------------------------------
-    void savePGM(const char* aFileName);
+    void savePGM(const char* aFileName, PGMFormat aFormat = PGM_ASCII);
     
     
     //------------------------------------------------------------------------
-    /// Save the image in a PGM file
+    /// Save the image in a PGM file (see above)
     /**
     * @param aFileName: the name of the file to write
+    * @param aFormat: the encoding of the pixels
     */
     //------------------------------------------------------------------------
-    void savePGM(const std::string& aFileName);
+    void savePGM(const std::string& aFileName, PGMFormat aFormat = PGM_ASCII);
     
 
     //------------------------------------------------------------------------
@@ -439,248 +1545,206 @@ public:
     void saveASCII(const std::string& aFileName);
    
    
-    //------------------------------------------------------------------------
-    /// Operator Equal to
-    /**
-    * @param anImage: the image to compare with
-    * @return true if the images are similar,
-    *         false if they are different
-    */
-    //------------------------------------------------------------------------
-    bool operator==(const Image& anImage) const;
-
-
-    //------------------------------------------------------------------------
-    /// Operator Not equal to
-    /**
-    * @param anImage: the image to compare with
-    * @return true if the images are different,
-    *         false if they are similar
-    */
-    //------------------------------------------------------------------------
-	bool operator!=(const Image& anImage) const;
-	/*Operators*/
-
-
+//******************************************************************************
+private:
 	//------------------------------------------------------------------------
-	/// Select function and creates kernel
+	/// Copy the pixels of a view (the buffer is reused if possible)
 	/**
-	* @param aFunctionID: the functionality selected
-	* @return a manipulated Image
+	* @param anImage: the view to copy
 	*/
 	//------------------------------------------------------------------------
-	Image selectFunction_3x3(int aFunctionId) const;
-
-
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
-	//								Statistics:
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
+	void copy(const ImageView& anImage);
 
 
 	//------------------------------------------------------------------------
-	/// Sum of All Errors
+	/// Change the storage of the rows. The pixels are kept.
 	/**
-	* @param anImage: the image to compare with
-	* @return true if the images are different,
-	*         false if they are similar
-	*/
-	//------------------------------------------------------------------------
-	float getSAE(const Image& anImage) const;
-
-	//------------------------------------------------------------------------
-	/// Normalized Cross Correlation
-	/**
-	* @param anImage: the position of the pixel along the horizontal axis
-	* @return: true if they are different
+	* @param anAlignedFlag: true to align the rows, false to pack them
+	* @param aHaloSize: the number of pixels around the (aligned) image
 	*/
 	//------------------------------------------------------------------------
-	float getNCC(const Image& anImage) const;
+	void setStorage(bool anAlignedFlag, unsigned int aHaloSize);
 
 
 	//------------------------------------------------------------------------
-	/// Creates a histogram
+	/// Change the size of the image. The buffer is kept if the number of
+	/// pixels (including the padding) does not change, otherwise it is
+	/// reallocated. The pixel values are undefined afterwards.
 	/**
-	* @param aNumberOfBins: the number of bins
-	* @return a histogram of floats
+	* @param aWidth: the new width
+	* @param aHeight: the new height
 	*/
 	//------------------------------------------------------------------------
-	float createHistogram(const int aNumberOfBins) const;
+	void setSize(unsigned int aWidth, unsigned int aHeight);
 
 
 	//------------------------------------------------------------------------
-	/// Set a pixel.
+	/// Compute every pixel of an expression into the current image.
 	/**
-	* @param i: the position of the pixel along the horizontal axis
-	* @param j: the position of the pixel along the vertical axis
-	* @param aValue: the new pixel value
+	* @param anExpression: the expression to evaluate
 	*/
 	//------------------------------------------------------------------------
-	unsigned int* getHistogram(unsigned int aNumberOfBins) const;
+	template<typename Expression> void evaluate(const Expression& anExpression);
 
 
 	//------------------------------------------------------------------------
-	/// Writes the histogram to a file
-	/**
-	* @param aNumberOfBins: number of bins selected
-	* @param aFIleName: name of the file
-	*/
-	//------------------------------------------------------------------------
-	void writeHistogram(unsigned int aNumberOfBins, const std::string& aFileName) const;
-
-	//------------------------------------------------------------------------
-	/// Writes the histogram to a file
-	/**
-	* @param aNumberOfBins: number of bins selected
-	* @param aFIleName: name of the file
-	*/
-	//------------------------------------------------------------------------
-	void writeHistogram(unsigned int aNumberOfBins, const char * aFileName) const;
-	
-	//------------------------------------------------------------------------
-	/// Gets the average
+	/// Add a weighted image in place: pixel += aWeight * pixel of anImage,
+	/// over the area common to both images, which becomes the new size.
 	/**
-	* @return an average
+	* @param anImage: the image to add
+	* @param aWeight: the weight of anImage
 	*/
 	//------------------------------------------------------------------------
-	float getAverage() const;
+	void accumulate(const ImageView& anImage, float aWeight);
 
-	//------------------------------------------------------------------------
-	/// Gets the variance
-	/**
-	* @return: the variance
-	*/
-	//------------------------------------------------------------------------
-	float getVariance() const;
 
-	//------------------------------------------------------------------------
-	/// Get the standard deviation
-	/**
-	* @return the standard deviation
-	*/
-	//------------------------------------------------------------------------
+    /// The memory allocated (m_p_image points inside of it)
+    float* m_p_buffer;
 
 
-	float getStandardDeviation() const;
+    /// Number of pixels allocated
+    unsigned int m_buffer_size;
 
-	/*Statistics.*/
 
+    /// The rows are aligned on cache lines
+    bool m_aligned_flag;
 
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
-	//								Filters:
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
 
+    /// Number of pixels allocated on each side of the (aligned) image
+    unsigned int m_halo_capacity;
 
-	/// Applies median filter
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float filter_Median(float n0, float n1, float n2, float n3, float n4, 
-		float n5, float n6, float n7, float n8);
 
-	/// Applies a laplacian edge detector
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float filter_Laplacian(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+    /// The filters write their result directly into images
+    friend class ImageView;
 
-	/// Applies a Prewitt edge detector
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float filter_Prewitt(float n0, float n1, float n2, float n3,
-		float n4, float n5, float n6, float n7, float n8);
 
-	///Applies the Sobel Edge Detector
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	int Image::filter_Sobel(float n0, float n1, float n2, float n3,
-		float n4, float n5, float n6, float n7, float n8);
-	/*Filters.*/
+    /// The integer images are converted directly into images
+    template<typename T> friend class PixelImage;
+};
 
 
-	//------------------------------------------------------------------------
-	//							Sharpen & Blur
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
-	
-	///Applies box blur to an image
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float blur_Box(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
-	
-	///Applies a Gaussian blur
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float blur_Gaussian(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
-	
-	///Applies a sharpening filter
-	/**
-	* @param n0-n8: pixel values passed in
-	* @return aPixelValue: the new pixel value
-	*/
-	//------------------------------------------------------------------------
-	float sharpenImg(float n0, float n1, float n2, float n3, float n4, float n5, float n6, float n7, float n8);
+//------------------------------------------------------------------------
+/// Exchange the pixels of two images without copying them (found by
+/// argument-dependent lookup, e.g. by std::sort).
+/**
+* @param anImage1: the first image
+* @param anImage2: the second image
+*/
+//------------------------------------------------------------------------
+void swap(Image& anImage1, Image& anImage2) noexcept;
 
-	//------------------------------------------------------------------------
-	//							Blend & Segnebt
-	//------------------------------------------------------------------------
-	//------------------------------------------------------------------------
 
-	//------------------------------------------------------------------------
-	/// Blends two images.
-	/**
-	* @param the image to be blended with
-	* @param the ratio the image will appear in
-	* @return a new image with both images blended
-	*/
-	//------------------------------------------------------------------------
-	Image blendImage(const Image& anImage, float blendRatio) const;
+//******************************************************************************
+//  Expressions
+//******************************************************************************
 
+//--------------------------------------------------
+inline ImageTerm::ImageTerm(const ImageView& anImage):
+//--------------------------------------------------
+        m_p_data(anImage.getRow(0)),
+        m_width(anImage.getWidth()),
+        m_height(anImage.getHeight()),
+        m_stride(anImage.getStride())
+//--------------------------------------------------
+{}
+
+
+//----------------------------------------------------------------------------------
+template<typename Left, typename Right, typename Operation>
+Image::Image(const BinaryExpression<Left, Right, Operation>& anExpression):
+//----------------------------------------------------------------------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
+//----------------------------------------------------------------------------------
+{
+    evaluate(anExpression);
+}
+
+
+//----------------------------------------------------------------------------------
+template<typename Operand, typename Operation>
+Image::Image(const ScalarExpression<Operand, Operation>& anExpression):
+//----------------------------------------------------------------------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
+//----------------------------------------------------------------------------------
+{
+    evaluate(anExpression);
+}
 
-	//------------------------------------------------------------------------
-	/// Segments an image
-	/**				
-	* @param the blending threshold
-	* @return the image with threshold applied
-	*/
-	//------------------------------------------------------------------------
-	Image segmentImage(const float threshold) const;
 
+//----------------------------------------------------------------------------------
+template<typename Left, typename Right, typename Operation>
+Image& Image::operator=(const BinaryExpression<Left, Right, Operation>& anExpression)
+//----------------------------------------------------------------------------------
+{
+    evaluate(anExpression);
 
+    return (*this);
+}
 
 
+//----------------------------------------------------------------------------------
+template<typename Operand, typename Operation>
+Image& Image::operator=(const ScalarExpression<Operand, Operation>& anExpression)
+//----------------------------------------------------------------------------------
+{
+    evaluate(anExpression);
 
-//******************************************************************************
-private:
-    /// Number of pixel along the horizontal axis
-    unsigned int m_width;
+    return (*this);
+}
 
 
-    /// Number of pixel along the vertical axis
-    unsigned int m_height;
+//-----------------------------------------------------------
+template<typename Expression>
+void Image::evaluate(const Expression& anExpression)
+//-----------------------------------------------------------
+{
+    const unsigned int width(anExpression.getWidth());
+    const unsigned int height(anExpression.getHeight());
+
+    // The expression reads the current buffer, which cannot be reused: use
+    // a temporary image. Otherwise every pixel is only read before being
+    // written, the computation can be done in place
+    if (anExpression.isUsing(m_p_image, m_p_image + m_height * m_stride) &&
+            (width != m_width || height != m_height))
+    {
+        Image temp;
+        temp.setStorage(m_aligned_flag, m_halo_capacity);
+        temp.evaluate(anExpression);
+        swap(temp);
+        return;
+    }
+
+    setSize(width, height);
+
+    // The rows of every image are contiguous and as wide as the result: single loop
+    if (m_stride == width && anExpression.isContiguous(width))
+    {
+        const unsigned int pixel_count(width * height);
+        for (unsigned int k(0); k < pixel_count; ++k)
+        {
+            m_p_image[k] = anExpression[k];
+        }
+    }
+    // Images of different widths (or views)
+    else
+    {
+        for (unsigned int j(0); j < height; ++j)
+        {
+            for (unsigned int i(0); i < width; ++i)
+            {
+                m_p_image[j * m_stride + i] = anExpression(i, j);
+            }
+        }
+    }
+}
 
-    
-    /// The pixel data
-    float* m_p_image;
-};
 
 #endif
@@ -0,0 +1,420 @@
+#ifndef IMAGE_EXPRESSION_H
+#define IMAGE_EXPRESSION_H
+
+
+/**
+********************************************************************************
+*
+*   @file       ImageExpression.h
+*
+*   @brief      Expression templates for the pixelwise arithmetic of Image.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min
+#include <cmath> // Header file for abs
+
+
+//******************************************************************************
+//  Class declaration
+//******************************************************************************
+class Image;
+class ImageView;
+
+
+//==============================================================================
+/**
+*   @class  ImageTerm
+*   @brief  Leaf of an expression: refers to the pixels of an image or of
+*           a view (they must outlive the expression).
+*
+*   Every node of an expression provides the size of its result, the pixel
+*   at a given index (when every image has the width of the result) or at a
+*   given position, and whether it reads pixels of a given buffer.
+*/
+//==============================================================================
+class ImageTerm
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //------------------------------------------------------------------------
+    /// Constructor (defined in Image.h).
+    /**
+    * @param anImage: the image or the view
+    */
+    //------------------------------------------------------------------------
+    ImageTerm(const ImageView& anImage);
+
+
+    unsigned int getWidth() const
+    {
+        return (m_width);
+    }
+
+
+    unsigned int getHeight() const
+    {
+        return (m_height);
+    }
+
+
+    float operator[](unsigned int anIndex) const
+    {
+        return (m_p_data[anIndex]);
+    }
+
+
+    float operator()(unsigned int i, unsigned int j) const
+    {
+        return (m_p_data[j * m_stride + i]);
+    }
+
+
+    bool isContiguous(unsigned int aWidth) const
+    {
+        return (m_width == aWidth && m_stride == aWidth);
+    }
+
+
+    bool isUsing(const float* apFirst, const float* apLast) const
+    {
+        return (m_height && m_p_data < apLast && apFirst < m_p_data + (m_height - 1) * m_stride + m_width);
+    }
+
+
+//******************************************************************************
+private:
+    /// The pixel data
+    const float* m_p_data;
+
+
+    /// Number of pixel along the horizontal axis
+    unsigned int m_width;
+
+
+    /// Number of pixel along the vertical axis
+    unsigned int m_height;
+
+
+    /// Number of pixels between the first pixels of two rows
+    unsigned int m_stride;
+};
+
+
+//******************************************************************************
+//  Operations
+//******************************************************************************
+
+/// a + b
+struct AddOperation
+{
+    static float apply(float a, float b) { return (a + b); }
+};
+
+
+/// a - b
+struct SubtractOperation
+{
+    static float apply(float a, float b) { return (a - b); }
+};
+
+
+/// a * b
+struct MultiplyOperation
+{
+    static float apply(float a, float b) { return (a * b); }
+};
+
+
+/// a / b
+struct DivideOperation
+{
+    static float apply(float a, float b) { return (a / b); }
+};
+
+
+//==============================================================================
+/**
+*   @class  BinaryExpression
+*   @brief  Pixelwise operation between two expressions. As with the
+*           operators of Image, the result has the smallest width and the
+*           smallest height of the operands.
+*/
+//==============================================================================
+template<typename Left, typename Right, typename Operation> class BinaryExpression
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    BinaryExpression(const Left& aLeft, const Right& aRight):
+            m_left(aLeft),
+            m_right(aRight)
+    {}
+
+
+    unsigned int getWidth() const
+    {
+        return (std::min(m_left.getWidth(), m_right.getWidth()));
+    }
+
+
+    unsigned int getHeight() const
+    {
+        return (std::min(m_left.getHeight(), m_right.getHeight()));
+    }
+
+
+    float operator[](unsigned int anIndex) const
+    {
+        return (Operation::apply(m_left[anIndex], m_right[anIndex]));
+    }
+
+
+    float operator()(unsigned int i, unsigned int j) const
+    {
+        return (Operation::apply(m_left(i, j), m_right(i, j)));
+    }
+
+
+    bool isContiguous(unsigned int aWidth) const
+    {
+        return (m_left.isContiguous(aWidth) && m_right.isContiguous(aWidth));
+    }
+
+
+    bool isUsing(const float* apFirst, const float* apLast) const
+    {
+        return (m_left.isUsing(apFirst, apLast) || m_right.isUsing(apFirst, apLast));
+    }
+
+
+//******************************************************************************
+private:
+    /// The operands (copied, leaves only refer to their image)
+    Left m_left;
+    Right m_right;
+};
+
+
+//==============================================================================
+/**
+*   @class  ScalarExpression
+*   @brief  Pixelwise operation between an expression and a value.
+*/
+//==============================================================================
+template<typename Operand, typename Operation> class ScalarExpression
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    ScalarExpression(const Operand& anOperand, float aValue):
+            m_operand(anOperand),
+            m_value(aValue)
+    {}
+
+
+    unsigned int getWidth() const
+    {
+        return (m_operand.getWidth());
+    }
+
+
+    unsigned int getHeight() const
+    {
+        return (m_operand.getHeight());
+    }
+
+
+    float operator[](unsigned int anIndex) const
+    {
+        return (Operation::apply(m_operand[anIndex], m_value));
+    }
+
+
+    float operator()(unsigned int i, unsigned int j) const
+    {
+        return (Operation::apply(m_operand(i, j), m_value));
+    }
+
+
+    bool isContiguous(unsigned int aWidth) const
+    {
+        return (m_operand.isContiguous(aWidth));
+    }
+
+
+    bool isUsing(const float* apFirst, const float* apLast) const
+    {
+        return (m_operand.isUsing(apFirst, apLast));
+    }
+
+
+//******************************************************************************
+private:
+    /// The operand
+    Operand m_operand;
+
+
+    /// The value
+    float m_value;
+};
+
+
+//******************************************************************************
+//  Operators
+//******************************************************************************
+
+/// The node storing an operand of type T in an expression. Only defined for
+/// Image, ImageView and the expressions, so the operators below ignore other
+/// types.
+template<typename T> struct ExpressionTerm {};
+
+template<> struct ExpressionTerm<Image>
+{
+    typedef ImageTerm Type;
+};
+
+template<> struct ExpressionTerm<ImageView>
+{
+    typedef ImageTerm Type;
+};
+
+template<typename Left, typename Right, typename Operation>
+struct ExpressionTerm<BinaryExpression<Left, Right, Operation> >
+{
+    typedef BinaryExpression<Left, Right, Operation> Type;
+};
+
+template<typename Operand, typename Operation>
+struct ExpressionTerm<ScalarExpression<Operand, Operation> >
+{
+    typedef ScalarExpression<Operand, Operation> Type;
+};
+
+
+//------------------------------------------------------------------------
+/// Addition operator. Nothing is computed until the expression is
+/// assigned to an Image, then every pixel is computed in a single loop
+/// without any temporary image. Do not store an expression (e.g. with
+/// auto): it refers to its images.
+/**
+* @param aLeft: the first image (or expression)
+* @param aRight: the image (or expression) to add
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Left, typename Right>
+BinaryExpression<typename ExpressionTerm<Left>::Type, typename ExpressionTerm<Right>::Type, AddOperation>
+operator+(const Left& aLeft, const Right& aRight)
+{
+    return (BinaryExpression<typename ExpressionTerm<Left>::Type, typename ExpressionTerm<Right>::Type, AddOperation>(
+            typename ExpressionTerm<Left>::Type(aLeft), typename ExpressionTerm<Right>::Type(aRight)));
+}
+
+
+//------------------------------------------------------------------------
+/// Subtraction operator (lazy, see operator+).
+/**
+* @param aLeft: the first image (or expression)
+* @param aRight: the image (or expression) to subtract
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Left, typename Right>
+BinaryExpression<typename ExpressionTerm<Left>::Type, typename ExpressionTerm<Right>::Type, SubtractOperation>
+operator-(const Left& aLeft, const Right& aRight)
+{
+    return (BinaryExpression<typename ExpressionTerm<Left>::Type, typename ExpressionTerm<Right>::Type, SubtractOperation>(
+            typename ExpressionTerm<Left>::Type(aLeft), typename ExpressionTerm<Right>::Type(aRight)));
+}
+
+
+//------------------------------------------------------------------------
+/// Addition operator. Add aValue to every pixel (lazy, see operator+).
+/**
+* @param anOperand: the image (or expression)
+* @param aValue: the value to add
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Operand>
+ScalarExpression<typename ExpressionTerm<Operand>::Type, AddOperation>
+operator+(const Operand& anOperand, float aValue)
+{
+    return (ScalarExpression<typename ExpressionTerm<Operand>::Type, AddOperation>(
+            typename ExpressionTerm<Operand>::Type(anOperand), aValue));
+}
+
+
+//------------------------------------------------------------------------
+/// Subtraction operator. Subtract aValue to every pixel (lazy, see
+/// operator+).
+/**
+* @param anOperand: the image (or expression)
+* @param aValue: the value to subtract
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Operand>
+ScalarExpression<typename ExpressionTerm<Operand>::Type, SubtractOperation>
+operator-(const Operand& anOperand, float aValue)
+{
+    return (ScalarExpression<typename ExpressionTerm<Operand>::Type, SubtractOperation>(
+            typename ExpressionTerm<Operand>::Type(anOperand), aValue));
+}
+
+
+//------------------------------------------------------------------------
+/// Multiplication operator. Multiply every pixel by aValue (lazy, see
+/// operator+).
+/**
+* @param anOperand: the image (or expression)
+* @param aValue: the value for the multiplication
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Operand>
+ScalarExpression<typename ExpressionTerm<Operand>::Type, MultiplyOperation>
+operator*(const Operand& anOperand, float aValue)
+{
+    return (ScalarExpression<typename ExpressionTerm<Operand>::Type, MultiplyOperation>(
+            typename ExpressionTerm<Operand>::Type(anOperand), aValue));
+}
+
+
+//------------------------------------------------------------------------
+/// Division operator. Divide every pixel by aValue (lazy, see operator+).
+/**
+* @param anOperand: the image (or expression)
+* @param aValue: the value for the division
+* @return the expression
+*/
+//------------------------------------------------------------------------
+template<typename Operand>
+ScalarExpression<typename ExpressionTerm<Operand>::Type, DivideOperation>
+operator/(const Operand& anOperand, float aValue)
+{
+    // Division by zero
+    if (std::abs(aValue) < 1.0e-6)
+    {
+        throw "Division by zero.";
+    }
+
+    return (ScalarExpression<typename ExpressionTerm<Operand>::Type, DivideOperation>(
+            typename ExpressionTerm<Operand>::Type(anOperand), aValue));
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+
+/**
+********************************************************************************
+*
+*   @file       MappedFile.h
+*
+*   @brief      Class to read a file through a memory mapping.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstddef> // Header file for size_t
+
+#include "Image.h"
+
+
+//==============================================================================
+/**
+*   @class  MappedFile
+*   @brief  MappedFile maps a whole file in memory (read only), so its
+*           content is read in place by the operating system instead of
+*           being copied through the buffers of a stream. It uses mmap on
+*           POSIX systems and a file mapping on Windows.
+*/
+//==============================================================================
+class MappedFile
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Header of a PGM file
+    struct PGMHeader
+    {
+        bool m_is_binary;                   ///< P5 (true) or P2 (false)
+        unsigned int m_width;               ///< number of pixels along the horizontal axis
+        unsigned int m_height;              ///< number of pixels along the vertical axis
+        unsigned int m_max_value;           ///< largest pixel value (1 to 65535)
+        unsigned int m_bytes_per_pixel;     ///< 1 or 2 (most significant first) for P5
+        const unsigned char* m_p_pixels;    ///< the first byte of the pixels
+    };
+
+
+    //------------------------------------------------------------------------
+    /// Default constructor (no file).
+    //------------------------------------------------------------------------
+    MappedFile();
+
+
+    //------------------------------------------------------------------------
+    /// Destructor. Unmap the file.
+    //------------------------------------------------------------------------
+    ~MappedFile();
+
+
+    //------------------------------------------------------------------------
+    /// Map a file (the previous one is unmapped)
+    /**
+    * @param aFileName: the name of the file to map
+    * @return true if the file is mapped, false if it cannot be opened
+    */
+    //------------------------------------------------------------------------
+    bool open(const char* aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Unmap the file
+    //------------------------------------------------------------------------
+    void close();
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on the content of the file
+    /**
+    * @return the first byte (NULL if the file is empty)
+    */
+    //------------------------------------------------------------------------
+    const unsigned char* getData() const;
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on the size of the file
+    /**
+    * @return the number of bytes
+    */
+    //------------------------------------------------------------------------
+    std::size_t getSize() const;
+
+
+    //------------------------------------------------------------------------
+    /// View of a raw file (floats, row after row). Nothing is copied: the
+    /// view is valid until the file is unmapped.
+    /**
+    * @param aWidth: the number of pixels along the horizontal axis
+    * @param aHeight: the number of pixels along the vertical axis
+    * @return the view of the pixels
+    */
+    //------------------------------------------------------------------------
+    ImageView getRawView(unsigned int aWidth, unsigned int aHeight) const;
+
+
+    //------------------------------------------------------------------------
+    /// Parse the header of a PGM file (P2 or P5). The pixels of a P5 file
+    /// must all be in the file.
+    /**
+    * @param aHeader: receives the header
+    * @return true if the header is valid, false otherwise
+    */
+    //------------------------------------------------------------------------
+    bool readPGMHeader(PGMHeader& aHeader) const;
+
+
+    //------------------------------------------------------------------------
+    /// Read a number of the header (or of the pixels of a P2 file) of a PGM
+    /// file, skipping the whitespaces and the comments.
+    /**
+    * @param apData: the current position in the file (can be NULL)
+    * @param aValue: receives the number
+    * @return the position after the number, NULL if there is no number
+    */
+    //------------------------------------------------------------------------
+    const unsigned char* readPGMValue(const unsigned char* apData,
+            unsigned int& aValue) const;
+
+
+//******************************************************************************
+private:
+    //------------------------------------------------------------------------
+    /// Copy constructor (disabled).
+    //------------------------------------------------------------------------
+    MappedFile(const MappedFile&);
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator (disabled).
+    //------------------------------------------------------------------------
+    MappedFile& operator=(const MappedFile&);
+
+
+    /// The content of the file
+    const unsigned char* m_p_data;
+
+
+    /// Number of bytes of the file
+    std::size_t m_size;
+
+
+#ifdef _WIN32
+    /// The file mapping object
+    void* m_p_mapping;
+#endif
+};
+
+#endif
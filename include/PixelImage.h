@@ -0,0 +1,852 @@
+#ifndef PIXEL_IMAGE_H
+#define PIXEL_IMAGE_H
+
+
+/**
+********************************************************************************
+*
+*   @file       PixelImage.h
+*
+*   @brief      Class to handle a greyscale image with integer pixels.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint> // Header file for uint8_t/uint16_t
+#include <algorithm> // Header file for min/max/minmax_element
+#include <fstream> // Header file for filestream
+#include <limits> // Header file for numeric_limits
+#include <sstream> // Header file for stringstream
+#include <string>
+#include <utility> // Header file for swap
+#include <vector>
+
+#include "Image.h"
+#include "MappedFile.h"
+#include "RowKernels.h"
+
+
+//==============================================================================
+/**
+*   @class  PixelImage
+*   @brief  PixelImage stores greyscale pixels as unsigned integers
+*           (std::uint8_t or std::uint16_t, see Image8 and Image16): an
+*           8-bit image uses a quarter of the memory and of the bandwidth of
+*           an Image, which is the float version. The pixelwise operations
+*           clamp their results to the range of the type and use saturating
+*           integer SIMD instructions. The other filters are applied after a
+*           conversion to an Image (toImage), and the result is converted
+*           back with the constructor from an ImageView.
+*/
+//==============================================================================
+template<typename T> class PixelImage
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    //------------------------------------------------------------------------
+    /// Default constructor (empty image).
+    //------------------------------------------------------------------------
+    PixelImage();
+
+
+    //------------------------------------------------------------------------
+    /// Constructor.
+    /**
+    * @param aWidth: the number of pixel along the horizontal axis
+    * @param aHeight: the number of pixel along the vertical axis
+    * @param aValue: the value of every pixel
+    */
+    //------------------------------------------------------------------------
+    PixelImage(unsigned int aWidth, unsigned int aHeight, T aValue = 0);
+
+
+    //------------------------------------------------------------------------
+    /// Conversion from float pixels: the values are rounded to the nearest
+    /// integer and clamped to the range of T.
+    /**
+    * @param anImage: the image (or the view) to convert
+    */
+    //------------------------------------------------------------------------
+    explicit PixelImage(const ImageView& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Largest value of a pixel
+    /**
+    * @return 255 for 8 bits, 65535 for 16 bits
+    */
+    //------------------------------------------------------------------------
+    static T getMaxPixelValue();
+
+
+    //------------------------------------------------------------------------
+    /// Number of pixels along the horizontal axis
+    /**
+    * @return the width
+    */
+    //------------------------------------------------------------------------
+    unsigned int getWidth() const;
+
+
+    //------------------------------------------------------------------------
+    /// Number of pixels along the vertical axis
+    /**
+    * @return the height
+    */
+    //------------------------------------------------------------------------
+    unsigned int getHeight() const;
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on a pixel value.
+    /**
+    * @param i: the position of the pixel along the horizontal axis
+    * @param j: the position of the pixel along the vertical axis
+    * @return the pixel value
+    */
+    //------------------------------------------------------------------------
+    T getPixel(unsigned int i, unsigned int j) const;
+
+
+    //------------------------------------------------------------------------
+    /// Set a pixel value.
+    /**
+    * @param i: the position of the pixel along the horizontal axis
+    * @param j: the position of the pixel along the vertical axis
+    * @param aValue: the new pixel value
+    */
+    //------------------------------------------------------------------------
+    void setPixel(unsigned int i, unsigned int j, T aValue);
+
+
+    //------------------------------------------------------------------------
+    /// Accessor on the first pixel of a row (the rows are contiguous).
+    /**
+    * @param j: the row
+    * @return the pixels of the row
+    */
+    //------------------------------------------------------------------------
+    const T* getRow(unsigned int j) const;
+    T* getRow(unsigned int j);
+
+
+    //------------------------------------------------------------------------
+    /// Change the size of the image. The pixel values are undefined.
+    /**
+    * @param aWidth: the number of pixel along the horizontal axis
+    * @param aHeight: the number of pixel along the vertical axis
+    */
+    //------------------------------------------------------------------------
+    void setSize(unsigned int aWidth, unsigned int aHeight);
+
+
+    //------------------------------------------------------------------------
+    /// Replace the pixels by float pixels, rounded and clamped.
+    /**
+    * @param anImage: the image (or the view) to convert
+    */
+    //------------------------------------------------------------------------
+    void convertFrom(const ImageView& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Convert the pixels to float into an existing image (its buffer is
+    /// reused if it has the right number of pixels).
+    /**
+    * @param anOutput: receives the float pixels
+    */
+    //------------------------------------------------------------------------
+    void convertTo(Image& anOutput) const;
+
+
+    //------------------------------------------------------------------------
+    /// Convert the pixels to float.
+    /**
+    * @return the float image
+    */
+    //------------------------------------------------------------------------
+    Image toImage() const;
+
+
+    //------------------------------------------------------------------------
+    /// Saturating addition. As with Image, the result has the smallest
+    /// width and the smallest height of the two images.
+    /**
+    * @param anImage: the image to add
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    PixelImage& operator+=(const PixelImage& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Saturating subtraction (negative values give 0).
+    /**
+    * @param anImage: the image to subtract
+    * @return the updated version of the current image
+    */
+    //------------------------------------------------------------------------
+    PixelImage& operator-=(const PixelImage& anImage);
+
+
+    //------------------------------------------------------------------------
+    /// Saturating addition.
+    /**
+    * @param anImage: the image to add
+    * @return the sum
+    */
+    //------------------------------------------------------------------------
+    PixelImage operator+(const PixelImage& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Saturating subtraction (negative values give 0).
+    /**
+    * @param anImage: the image to subtract
+    * @return the difference
+    */
+    //------------------------------------------------------------------------
+    PixelImage operator-(const PixelImage& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Absolute difference, e.g. between two frames.
+    /**
+    * @param anImage: the other image
+    * @return |current image - anImage|
+    */
+    //------------------------------------------------------------------------
+    PixelImage getAbsoluteDifference(const PixelImage& anImage) const;
+
+
+    //------------------------------------------------------------------------
+    /// Compute the negative image. As with Image, the dynamic of the image
+    /// is preserved: min + max - value.
+    /**
+    * @return the negative image
+    */
+    //------------------------------------------------------------------------
+    PixelImage invert() const;
+
+
+    //------------------------------------------------------------------------
+    /// Segment the image as Image::segmentImage does: the pixels below the
+    /// threshold become 0, those above become the largest pixel value.
+    /**
+    * @param aThreshold: the threshold
+    * @return the segmented image
+    */
+    //------------------------------------------------------------------------
+    PixelImage segmentImage(T aThreshold) const;
+
+
+    //------------------------------------------------------------------------
+    /// Histogram with a bin per pixel value (256 bins for 8 bits, 65536 for
+    /// 16 bits), computed in a single pass with 4 sub-histograms.
+    /**
+    * @return the number of pixels of every value
+    */
+    //------------------------------------------------------------------------
+    std::vector<unsigned int> getHistogram() const;
+
+
+    //------------------------------------------------------------------------
+    /// Load a PGM file (ASCII or binary, 8 or 16 bits). The values are
+    /// kept unscaled, unless the maximum value of the file is larger than
+    /// the one of T (e.g. a 16-bit file in an Image8): they are then
+    /// rescaled to the range of T.
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadPGM(const char* aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Load a PGM file (ASCII or binary, 8 or 16 bits). The values are
+    /// kept unscaled, unless the maximum value of the file is larger than
+    /// the one of T (e.g. a 16-bit file in an Image8): they are then
+    /// rescaled to the range of T.
+    /**
+    * @param aFileName: the name of the file to load
+    */
+    //------------------------------------------------------------------------
+    void loadPGM(const std::string& aFileName);
+
+
+    //------------------------------------------------------------------------
+    /// Save the image in a binary PGM file (P5). The maximum value of the
+    /// file is the largest pixel value, at least 255: the pixels take one
+    /// byte if it is 255, two bytes in big-endian order otherwise.
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //------------------------------------------------------------------------
+    void savePGM(const char* aFileName) const;
+
+
+    //------------------------------------------------------------------------
+    /// Save the image in a binary PGM file (P5). The maximum value of the
+    /// file is the largest pixel value, at least 255: the pixels take one
+    /// byte if it is 255, two bytes in big-endian order otherwise.
+    /**
+    * @param aFileName: the name of the file to write
+    */
+    //------------------------------------------------------------------------
+    void savePGM(const std::string& aFileName) const;
+
+
+//******************************************************************************
+private:
+    //------------------------------------------------------------------------
+    /// Combine two images pixel by pixel into an existing image.
+    /**
+    * @param anImage: the other image
+    * @param anOperation: the operation
+    * @param anOutput: receives the result (can be one of the images)
+    */
+    //------------------------------------------------------------------------
+    void combine(const PixelImage& anImage,
+            RowKernels::IntegerOperation anOperation,
+            PixelImage& anOutput) const;
+
+
+    //------------------------------------------------------------------------
+    /// Convert a value of a PGM file to a pixel value.
+    /**
+    * @param aValue: the value read from the file
+    * @param aMaxValue: the maximum value of the file
+    * @return the pixel value (rescaled if aMaxValue is larger than the
+    *         maximum value of T)
+    */
+    //------------------------------------------------------------------------
+    static T convertFileValue(unsigned int aValue, unsigned int aMaxValue);
+
+
+    /// The pixel data (row after row)
+    std::vector<T> m_pixel_set;
+
+
+    /// Number of pixel along the horizontal axis
+    unsigned int m_width;
+
+
+    /// Number of pixel along the vertical axis
+    unsigned int m_height;
+};
+
+
+/// Image with 8-bit pixels
+typedef PixelImage<std::uint8_t> Image8;
+
+
+/// Image with 16-bit pixels
+typedef PixelImage<std::uint16_t> Image16;
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T>::PixelImage():
+//------------------------------------------------------------------------
+        m_width(0),
+        m_height(0)
+//------------------------------------------------------------------------
+{}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T>::PixelImage(unsigned int aWidth, unsigned int aHeight, T aValue):
+//------------------------------------------------------------------------
+        m_pixel_set(std::size_t(aWidth) * aHeight, aValue),
+        m_width(aWidth),
+        m_height(aHeight)
+//------------------------------------------------------------------------
+{}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T>::PixelImage(const ImageView& anImage):
+//------------------------------------------------------------------------
+        m_width(0),
+        m_height(0)
+//------------------------------------------------------------------------
+{
+    convertFrom(anImage);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+T PixelImage<T>::getMaxPixelValue()
+//------------------------------------------------------------------------
+{
+    return (std::numeric_limits<T>::max());
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+unsigned int PixelImage<T>::getWidth() const
+//------------------------------------------------------------------------
+{
+    return (m_width);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+unsigned int PixelImage<T>::getHeight() const
+//------------------------------------------------------------------------
+{
+    return (m_height);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+T PixelImage<T>::getPixel(unsigned int i, unsigned int j) const
+//------------------------------------------------------------------------
+{
+    // The pixel does not exist
+    if (i >= m_width || j >= m_height)
+    {
+        throw "Invalid pixel coordinates";
+    }
+
+    return (m_pixel_set[std::size_t(j) * m_width + i]);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::setPixel(unsigned int i, unsigned int j, T aValue)
+//------------------------------------------------------------------------
+{
+    // The pixel does not exist
+    if (i >= m_width || j >= m_height)
+    {
+        throw "Invalid pixel coordinates";
+    }
+
+    m_pixel_set[std::size_t(j) * m_width + i] = aValue;
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+const T* PixelImage<T>::getRow(unsigned int j) const
+//------------------------------------------------------------------------
+{
+    return (m_pixel_set.data() + std::size_t(j) * m_width);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+T* PixelImage<T>::getRow(unsigned int j)
+//------------------------------------------------------------------------
+{
+    return (m_pixel_set.data() + std::size_t(j) * m_width);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::setSize(unsigned int aWidth, unsigned int aHeight)
+//------------------------------------------------------------------------
+{
+    // The vector keeps its memory if it is large enough
+    m_pixel_set.resize(std::size_t(aWidth) * aHeight);
+    m_width = aWidth;
+    m_height = aHeight;
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::convertFrom(const ImageView& anImage)
+//------------------------------------------------------------------------
+{
+    setSize(anImage.getWidth(), anImage.getHeight());
+
+    // The rows of a view are not contiguous
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        RowKernels::convert(anImage.getRow(j), getRow(j), m_width);
+    }
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::convertTo(Image& anOutput) const
+//------------------------------------------------------------------------
+{
+    // Reuse the buffer of the output if possible
+    anOutput.setSize(m_width, m_height);
+
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        const T* p_input(getRow(j));
+        float* p_output(anOutput.getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            p_output[i] = p_input[i];
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+Image PixelImage<T>::toImage() const
+//------------------------------------------------------------------------
+{
+    Image temp;
+    convertTo(temp);
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T>& PixelImage<T>::operator+=(const PixelImage& anImage)
+//------------------------------------------------------------------------
+{
+    combine(anImage, RowKernels::ADD_SATURATE, *this);
+    return (*this);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T>& PixelImage<T>::operator-=(const PixelImage& anImage)
+//------------------------------------------------------------------------
+{
+    combine(anImage, RowKernels::SUBTRACT_SATURATE, *this);
+    return (*this);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T> PixelImage<T>::operator+(const PixelImage& anImage) const
+//------------------------------------------------------------------------
+{
+    PixelImage temp;
+    combine(anImage, RowKernels::ADD_SATURATE, temp);
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T> PixelImage<T>::operator-(const PixelImage& anImage) const
+//------------------------------------------------------------------------
+{
+    PixelImage temp;
+    combine(anImage, RowKernels::SUBTRACT_SATURATE, temp);
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T> PixelImage<T>::getAbsoluteDifference(const PixelImage& anImage) const
+//------------------------------------------------------------------------
+{
+    PixelImage temp;
+    combine(anImage, RowKernels::ABSOLUTE_DIFFERENCE, temp);
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T> PixelImage<T>::invert() const
+//------------------------------------------------------------------------
+{
+    PixelImage temp;
+    temp.setSize(m_width, m_height);
+
+    if (!m_pixel_set.empty())
+    {
+        // min + max - value stays in [min, max]
+        const int sum(*std::min_element(m_pixel_set.begin(), m_pixel_set.end()) +
+                *std::max_element(m_pixel_set.begin(), m_pixel_set.end()));
+
+        for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+        {
+            temp.m_pixel_set[i] = T(sum - m_pixel_set[i]);
+        }
+    }
+
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+PixelImage<T> PixelImage<T>::segmentImage(T aThreshold) const
+//------------------------------------------------------------------------
+{
+    const T black(0);
+    const T white(getMaxPixelValue());
+
+    PixelImage temp;
+    temp.setSize(m_width, m_height);
+
+    for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+    {
+        const T value(m_pixel_set[i]);
+        temp.m_pixel_set[i] = value < aThreshold ? black : (value > aThreshold ? white : value);
+    }
+
+    return (temp);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+std::vector<unsigned int> PixelImage<T>::getHistogram() const
+//------------------------------------------------------------------------
+{
+    const std::size_t bin_count(std::size_t(getMaxPixelValue()) + 1);
+
+    // Pixel k goes to the sub-histogram k % 4, so a run of identical pixels
+    // does not wait for the previous increment of the same counter
+    std::vector<unsigned int> sub_histogram_set(4 * bin_count, 0);
+    for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+    {
+        ++sub_histogram_set[(i & 3) * bin_count + m_pixel_set[i]];
+    }
+
+    // Merge the sub-histograms
+    std::vector<unsigned int> histogram(bin_count);
+    for (std::size_t i(0); i < bin_count; ++i)
+    {
+        histogram[i] = sub_histogram_set[i] + sub_histogram_set[bin_count + i] +
+                sub_histogram_set[2 * bin_count + i] + sub_histogram_set[3 * bin_count + i];
+    }
+
+    return (histogram);
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::combine(const PixelImage& anImage,
+        RowKernels::IntegerOperation anOperation,
+        PixelImage& anOutput) const
+//------------------------------------------------------------------------
+{
+    const unsigned int width(std::min(m_width, anImage.m_width));
+    const unsigned int height(std::min(m_height, anImage.m_height));
+
+    // Resizing an input would move its rows
+    if ((&anOutput == this || &anOutput == &anImage) &&
+            (anOutput.m_width != width || anOutput.m_height != height))
+    {
+        PixelImage temp;
+        combine(anImage, anOperation, temp);
+        std::swap(anOutput.m_pixel_set, temp.m_pixel_set);
+        std::swap(anOutput.m_width, temp.m_width);
+        std::swap(anOutput.m_height, temp.m_height);
+        return;
+    }
+
+    anOutput.setSize(width, height);
+
+    // The pixels are processed in place if the output is an input
+    for (unsigned int j(0); j < height; ++j)
+    {
+        RowKernels::combine(getRow(j), anImage.getRow(j), anOutput.getRow(j), width, anOperation);
+    }
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+T PixelImage<T>::convertFileValue(unsigned int aValue, unsigned int aMaxValue)
+//------------------------------------------------------------------------
+{
+    const unsigned int max_pixel_value(getMaxPixelValue());
+
+    // The range of the file is larger: rescale (rounded to the nearest)
+    if (aMaxValue > max_pixel_value)
+    {
+        aValue = std::min(aValue, aMaxValue);
+        return (T((aValue * max_pixel_value + aMaxValue / 2) / aMaxValue));
+    }
+
+    return (T(std::min(aValue, max_pixel_value)));
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::loadPGM(const char* aFileName)
+//------------------------------------------------------------------------
+{
+    // Map the file: the header and the pixels are read in place
+    MappedFile input_file;
+
+    // The file does not exist
+    if (!input_file.open(aFileName))
+    {
+        // Build the error message
+        std::stringstream error_message;
+        error_message << "Cannot open the file \"" << aFileName << "\". It does not exist";
+
+        // Throw an error
+        throw (error_message.str());
+    }
+
+    // Invalid format, or truncated binary file
+    MappedFile::PGMHeader header;
+    if (!input_file.readPGMHeader(header))
+    {
+        // Build the error message
+        std::stringstream error_message;
+        error_message << "Invalid file (\"" << aFileName << "\")";
+
+        // Throw an error
+        throw (error_message.str());
+    }
+
+    setSize(header.m_width, header.m_height);
+
+    const unsigned char* p_data(header.m_p_pixels);
+    if (!header.m_is_binary)
+    {
+        for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+        {
+            unsigned int value(0);
+            p_data = input_file.readPGMValue(p_data, value);
+
+            // The file is truncated
+            if (!p_data)
+            {
+                // Build the error message
+                std::stringstream error_message;
+                error_message << "Invalid file (\"" << aFileName << "\")";
+
+                // Throw an error
+                throw (error_message.str());
+            }
+
+            m_pixel_set[i] = convertFileValue(value, header.m_max_value);
+        }
+    }
+    // 8-bit file into 8-bit pixels: a single copy from the mapping
+    else if (header.m_bytes_per_pixel == 1 && sizeof(T) == 1)
+    {
+        std::copy(p_data, p_data + m_pixel_set.size(), reinterpret_cast<unsigned char*>(m_pixel_set.data()));
+    }
+    else
+    {
+        const unsigned int bytes_per_pixel(header.m_bytes_per_pixel);
+        for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+        {
+            // The most significant byte first
+            unsigned int value(p_data[i * bytes_per_pixel]);
+            if (bytes_per_pixel == 2)
+            {
+                value = (value << 8) | p_data[i * 2 + 1];
+            }
+            m_pixel_set[i] = convertFileValue(value, header.m_max_value);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::loadPGM(const std::string& aFileName)
+//------------------------------------------------------------------------
+{
+    loadPGM(aFileName.data());
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::savePGM(const char* aFileName) const
+//------------------------------------------------------------------------
+{
+    // Open the file
+    std::ofstream output_file(aFileName, std::ofstream::binary);
+
+    // The file does not exist
+    if (!output_file.is_open())
+    {
+        // Build the error message
+        std::stringstream error_message;
+        error_message << "Cannot create the file \"" << aFileName << "\"";
+
+        // Throw an error
+        throw (error_message.str());
+    }
+
+    // The header
+    output_file << "P5" << std::endl;
+    output_file << "# ICP3038 -- Assignment 1 -- 2016/2017" << std::endl;
+    output_file << m_width << " " << m_height << std::endl;
+
+    // The largest value of the data (at least 255): the file is not
+    // rescaled when it is loaded in an Image8 if the data fit in 8 bits
+    unsigned int max_value(255);
+    if (sizeof(T) > 1 && !m_pixel_set.empty())
+    {
+        max_value = std::max(max_value, unsigned(*std::max_element(m_pixel_set.begin(), m_pixel_set.end())));
+    }
+    output_file << max_value << std::endl;
+
+    // The pixels in a single write
+    if (sizeof(T) == 1)
+    {
+        output_file.write(reinterpret_cast<const char*>(m_pixel_set.data()), m_pixel_set.size());
+    }
+    // One byte per pixel if the maximum value is less than 256
+    else if (max_value < 256)
+    {
+        const std::vector<unsigned char> byte_set(m_pixel_set.begin(), m_pixel_set.end());
+        output_file.write(reinterpret_cast<const char*>(byte_set.data()), byte_set.size());
+    }
+    else
+    {
+        std::vector<unsigned char> byte_set(m_pixel_set.size() * 2);
+        for (std::size_t i(0); i < m_pixel_set.size(); ++i)
+        {
+            // The most significant byte first
+            byte_set[i * 2] = (unsigned char)(m_pixel_set[i] >> 8);
+            byte_set[i * 2 + 1] = (unsigned char)(m_pixel_set[i] & 255);
+        }
+        output_file.write(reinterpret_cast<const char*>(byte_set.data()), byte_set.size());
+    }
+}
+
+
+//------------------------------------------------------------------------
+template<typename T>
+void PixelImage<T>::savePGM(const std::string& aFileName) const
+//------------------------------------------------------------------------
+{
+    savePGM(aFileName.data());
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef ROW_KERNELS_H
+#define ROW_KERNELS_H
+
+
+/**
+********************************************************************************
+*
+*   @file       RowKernels.h
+*
+*   @brief      Vectorised functions processing a row of pixels at once.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cstdint> // Header file for uint8_t/uint16_t
+
+
+//==============================================================================
+/**
+*   @class  RowKernels
+*   @brief  RowKernels gathers the functions that process a whole row of
+*           pixels with SIMD instructions. The instruction set (AVX2, SSE or
+*           plain C++) is selected at runtime depending on the CPU.
+*
+*   The 3x3 functions take three rows (above, current, below). The pointers
+*   point at the first output pixel, the neighbour at index -1 and the
+*   neighbour at index aCount must be readable.
+*/
+//==============================================================================
+class RowKernels
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// Instruction sets supported by the row kernels
+    enum InstructionSet
+    {
+        SCALAR, ///< plain C++
+        SSE,    ///< 4 pixels at once
+        AVX2    ///< 8 pixels at once
+    };
+
+
+    /// Gradient operators: the derivative [-1 0 1] smoothed by [1 1 1]
+    /// (PREWITT), [1 2 1] (SOBEL) or [3 10 3] (SCHARR), or the differences
+    /// along the diagonals of the 2x2 pixels at the bottom right (ROBERTS)
+    enum GradientOperator
+    {
+        PREWITT,
+        SOBEL,
+        SCHARR,
+        ROBERTS
+    };
+
+
+    /// Pixelwise operations on integer pixels, the result is clamped to the
+    /// range of the pixel type
+    enum IntegerOperation
+    {
+        ADD_SATURATE,           ///< a + b
+        SUBTRACT_SATURATE,      ///< a - b
+        ABSOLUTE_DIFFERENCE     ///< |a - b|
+    };
+
+
+    /// Statistics of a row of pixels (see getStatistics)
+    struct RowStatistics
+    {
+        float m_min_value;      ///< the smallest pixel
+        float m_max_value;      ///< the largest pixel
+        double m_sum;           ///< sum of (pixel - shift)
+        double m_square_sum;    ///< sum of (pixel - shift)^2
+    };
+
+
+    /// Sums comparing two rows of pixels (see compare)
+    struct RowComparison
+    {
+        double m_absolute_sum;          ///< sum of |a - b|
+        double m_square_sum;            ///< sum of (a - b)^2
+        double m_first_sum;             ///< sum of (a - first shift)
+        double m_second_sum;            ///< sum of (b - second shift)
+        double m_first_square_sum;      ///< sum of (a - first shift)^2
+        double m_second_square_sum;     ///< sum of (b - second shift)^2
+        double m_product_sum;           ///< sum of (a - first shift) (b - second shift)
+    };
+
+
+    /// Output images of one operator of gradient_3x3
+    struct GradientOutput
+    {
+        GradientOperator m_operator;    ///< the operator
+        float* m_p_magnitude;           ///< the magnitudes
+        float* m_p_direction;           ///< the directions (can be NULL)
+    };
+
+
+    //------------------------------------------------------------------------
+    /// Instruction set in use
+    /**
+    * @return the instruction set
+    */
+    //------------------------------------------------------------------------
+    static InstructionSet getInstructionSet();
+
+
+    //------------------------------------------------------------------------
+    /// Force the instruction set (e.g. to compare with the scalar version).
+    /// It is capped to the best instruction set supported by the CPU.
+    /**
+    * @param anInstructionSet: the instruction set to use
+    */
+    //------------------------------------------------------------------------
+    static void setInstructionSet(InstructionSet anInstructionSet);
+
+
+    //------------------------------------------------------------------------
+    /// Best instruction set supported by the CPU
+    /**
+    * @return the instruction set
+    */
+    //------------------------------------------------------------------------
+    static InstructionSet getSupportedInstructionSet();
+
+
+    //------------------------------------------------------------------------
+    /// Apply a 3x3 kernel: the nine weighted neighbours (row-major order)
+    /// are summed one after the other, then divided by aDivisor.
+    /// The result is identical whatever the instruction set.
+    /**
+    * @param apAbove: the row above the output row
+    * @param apRow: the row of the output pixels
+    * @param apBelow: the row below the output row
+    * @param apOutput: the output pixels
+    * @param aCount: the number of output pixels
+    * @param apKernel: the 9 weights
+    * @param aDivisor: the normalisation factor
+    */
+    //------------------------------------------------------------------------
+    static void convolve_3x3(const float* apAbove,
+            const float* apRow,
+            const float* apBelow,
+            float* apOutput,
+            unsigned int aCount,
+            const float* apKernel,
+            float aDivisor);
+
+
+    //------------------------------------------------------------------------
+    /// Median of the 3x3 neighbourhood of every pixel, computed with a
+    /// branchless sorting network of 19 compare-exchanges (min/max).
+    /**
+    * @param apAbove: the row above the output row
+    * @param apRow: the row of the output pixels
+    * @param apBelow: the row below the output row
+    * @param apOutput: the output pixels
+    * @param aCount: the number of output pixels
+    */
+    //------------------------------------------------------------------------
+    static void median_3x3(const float* apAbove,
+            const float* apRow,
+            const float* apBelow,
+            float* apOutput,
+            unsigned int aCount);
+
+
+    //------------------------------------------------------------------------
+    /// Median of 9 values with the same sorting network
+    /**
+    * @param apValues: the 9 values (they are partially sorted in place)
+    * @return the median
+    */
+    //------------------------------------------------------------------------
+    static float getMedian9(float* apValues);
+
+
+    //------------------------------------------------------------------------
+    /// Gradients of every pixel for several operators in a single pass: the
+    /// derivative of each row and of each column of the neighbourhood are
+    /// computed from one load of the 9 pixels and shared by the operators,
+    /// then every operator smooths them and stores its magnitude and,
+    /// optionally, its direction. The direction is atan2(gy, gx) in
+    /// [-pi, pi] (polynomial approximation, error about 1e-5 radian), with
+    /// x towards the right and y towards the bottom of the image.
+    /**
+    * @param apAbove: the row above the output row
+    * @param apRow: the row of the output pixels
+    * @param apBelow: the row below the output row
+    * @param apOutputSet: the operators and their output images
+    * @param anOutputCount: the number of operators
+    * @param anOffset: the index of the first output pixel in the images
+    * @param aCount: the number of output pixels
+    * @param anL2NormFlag: true for sqrt(gx^2 + gy^2), false for |gx| + |gy|
+    */
+    //------------------------------------------------------------------------
+    static void gradient_3x3(const float* apAbove,
+            const float* apRow,
+            const float* apBelow,
+            const GradientOutput* apOutputSet,
+            unsigned int anOutputCount,
+            unsigned int anOffset,
+            unsigned int aCount,
+            bool anL2NormFlag);
+
+
+    //------------------------------------------------------------------------
+    /// Multiply a row by a weight and add it to another row:
+    /// apOutput[i] += apInput[i] * aWeight
+    /**
+    * @param apInput: the row to weight
+    * @param aWeight: the weight
+    * @param apOutput: the row to update
+    * @param aCount: the number of pixels
+    */
+    //------------------------------------------------------------------------
+    static void multiplyAdd(const float* apInput,
+            float aWeight,
+            float* apOutput,
+            unsigned int aCount);
+
+
+    //------------------------------------------------------------------------
+    /// Minimum, maximum, and sums of the pixels of a row in a single pass.
+    /// The sums are accumulated in double precision on the pixels minus
+    /// aShift: the differences and their squares are exact, so the variance
+    /// computed from the sums does not suffer from cancellation when aShift
+    /// is close to the mean (e.g. a pixel of the image).
+    /**
+    * @param apRow: the pixels
+    * @param aCount: the number of pixels (at least 1)
+    * @param aShift: the value subtracted from the pixels in the sums
+    * @param aStatistics: receives the statistics of the row
+    */
+    //------------------------------------------------------------------------
+    static void getStatistics(const float* apRow,
+            unsigned int aCount,
+            float aShift,
+            RowStatistics& aStatistics);
+
+
+    //------------------------------------------------------------------------
+    /// Every sum needed by the comparison metrics (SAE, SSD, NCC) of two
+    /// rows in a single pass, accumulated in double precision (as
+    /// getStatistics, the shifted pixels and their products are exact).
+    /**
+    * @param apFirst: the pixels of the first row (a)
+    * @param apSecond: the pixels of the second row (b)
+    * @param aCount: the number of pixels
+    * @param aFirstShift: the value subtracted from a in the sums
+    * @param aSecondShift: the value subtracted from b in the sums
+    * @param aComparison: receives the sums of the rows
+    */
+    //------------------------------------------------------------------------
+    static void compare(const float* apFirst,
+            const float* apSecond,
+            unsigned int aCount,
+            float aFirstShift,
+            float aSecondShift,
+            RowComparison& aComparison);
+
+
+    //------------------------------------------------------------------------
+    /// Combine two rows of 8-bit pixels with saturating integer arithmetic
+    /**
+    * @param apFirst: the first row
+    * @param apSecond: the second row
+    * @param apOutput: the output row (can be one of the inputs)
+    * @param aCount: the number of pixels
+    * @param anOperation: the operation
+    */
+    //------------------------------------------------------------------------
+    static void combine(const std::uint8_t* apFirst,
+            const std::uint8_t* apSecond,
+            std::uint8_t* apOutput,
+            unsigned int aCount,
+            IntegerOperation anOperation);
+
+
+    //------------------------------------------------------------------------
+    /// Combine two rows of 16-bit pixels with saturating integer arithmetic
+    /**
+    * @param apFirst: the first row
+    * @param apSecond: the second row
+    * @param apOutput: the output row (can be one of the inputs)
+    * @param aCount: the number of pixels
+    * @param anOperation: the operation
+    */
+    //------------------------------------------------------------------------
+    static void combine(const std::uint16_t* apFirst,
+            const std::uint16_t* apSecond,
+            std::uint16_t* apOutput,
+            unsigned int aCount,
+            IntegerOperation anOperation);
+
+
+    //------------------------------------------------------------------------
+    /// Convert a row of float pixels to 8 bits: the values are rounded to
+    /// the nearest integer and clamped to [0, 255] (NaN gives 0)
+    /**
+    * @param apInput: the float pixels
+    * @param apOutput: the 8-bit pixels
+    * @param aCount: the number of pixels
+    */
+    //------------------------------------------------------------------------
+    static void convert(const float* apInput,
+            std::uint8_t* apOutput,
+            unsigned int aCount);
+
+
+    //------------------------------------------------------------------------
+    /// Convert a row of float pixels to 16 bits: the values are rounded to
+    /// the nearest integer and clamped to [0, 65535] (NaN gives 0)
+    /**
+    * @param apInput: the float pixels
+    * @param apOutput: the 16-bit pixels
+    * @param aCount: the number of pixels
+    */
+    //------------------------------------------------------------------------
+    static void convert(const float* apInput,
+            std::uint16_t* apOutput,
+            unsigned int aCount);
+
+
+    //------------------------------------------------------------------------
+    /// Convert a row of 8-bit pixels to float
+    /**
+    * @param apInput: the 8-bit pixels
+    * @param apOutput: the float pixels
+    * @param aCount: the number of pixels
+    */
+    //------------------------------------------------------------------------
+    static void convert(const std::uint8_t* apInput,
+            float* apOutput,
+            unsigned int aCount);
+};
+
+#endif
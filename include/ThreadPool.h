@@ -0,0 +1,199 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+/**
+********************************************************************************
+*
+*   @file       ThreadPool.h
+*
+*   @brief      Class to run row bands of an image on worker threads.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+
+//==============================================================================
+/**
+*   @class  ThreadPool
+*   @brief  ThreadPool is a fixed set of worker threads that process
+*           contiguous bands of a range (e.g. the rows of an image).
+*/
+//==============================================================================
+class ThreadPool
+//------------------------------------------------------------------------------
+{
+//******************************************************************************
+public:
+    /// A task processes the band [aFirst, aLast). It only refers to the
+    /// function object (no copy, no memory allocation, unlike
+    /// std::function), which must outlive the call to parallelFor.
+    class Task
+    {
+    public:
+        template<typename Function> Task(const Function& aFunction):
+                m_p_function(&aFunction),
+                m_p_call(&call<Function>)
+        {}
+
+
+        void operator()(unsigned int aFirst, unsigned int aLast) const
+        {
+            m_p_call(m_p_function, aFirst, aLast);
+        }
+
+
+    private:
+        template<typename Function> static void call(const void* apFunction,
+                unsigned int aFirst,
+                unsigned int aLast)
+        {
+            (*static_cast<const Function*>(apFunction))(aFirst, aLast);
+        }
+
+
+        /// The function object
+        const void* m_p_function;
+
+
+        /// Call the function object with its actual type
+        void (*m_p_call)(const void*, unsigned int, unsigned int);
+    };
+
+
+    //------------------------------------------------------------------------
+    /// Constructor.
+    /**
+    * @param aNumberOfThreads: the number of threads (including the caller),
+    *                          0 to use every hardware thread
+    */
+    //------------------------------------------------------------------------
+    ThreadPool(unsigned int aNumberOfThreads);
+
+
+    //------------------------------------------------------------------------
+    /// Destructor. Stop and join the worker threads.
+    //------------------------------------------------------------------------
+    ~ThreadPool();
+
+
+    //------------------------------------------------------------------------
+    /// Number of threads used to process a range, including the caller
+    /**
+    * @return the number of threads
+    */
+    //------------------------------------------------------------------------
+    unsigned int getNumberOfThreads() const;
+
+
+    //------------------------------------------------------------------------
+    /// Split [aFirst, aLast) into contiguous bands, one per thread, and
+    /// process them. The caller processes the first band and returns when
+    /// every band is done. An exception thrown by a task is re-thrown here.
+    /**
+    * @param aFirst: the start of the range
+    * @param aLast: the end of the range (excluded)
+    * @param aTask: the function called on every band
+    */
+    //------------------------------------------------------------------------
+    void parallelFor(unsigned int aFirst, unsigned int aLast, const Task& aTask);
+
+
+//******************************************************************************
+private:
+    //------------------------------------------------------------------------
+    /// Copy constructor (disabled).
+    //------------------------------------------------------------------------
+    ThreadPool(const ThreadPool&);
+
+
+    //------------------------------------------------------------------------
+    /// Assignment operator (disabled).
+    //------------------------------------------------------------------------
+    ThreadPool& operator=(const ThreadPool&);
+
+
+    //------------------------------------------------------------------------
+    /// Main loop of a worker thread.
+    /**
+    * @param aThreadIndex: the index of the band processed by the thread
+    */
+    //------------------------------------------------------------------------
+    void run(unsigned int aThreadIndex);
+
+
+    //------------------------------------------------------------------------
+    /// Process the band of a given thread and record any error.
+    /**
+    * @param aThreadIndex: the index of the band to process
+    */
+    //------------------------------------------------------------------------
+    void processBand(unsigned int aThreadIndex);
+
+
+    /// The worker threads (the caller is not stored)
+    std::vector<std::thread> m_thread_set;
+
+
+    /// Serialise the calls to parallelFor
+    std::mutex m_dispatch_mutex;
+
+
+    /// Protect the state shared with the workers
+    std::mutex m_mutex;
+
+
+    /// Wake the workers up when a new range is posted
+    std::condition_variable m_start_condition;
+
+
+    /// Wake the caller up when the last worker is done
+    std::condition_variable m_done_condition;
+
+
+    /// Incremented every time a new range is posted
+    unsigned long m_generation;
+
+
+    /// Number of workers still processing the current range
+    unsigned int m_pending_count;
+
+
+    /// The workers must exit
+    bool m_stop;
+
+
+    /// The current task
+    const Task* m_p_task;
+
+
+    /// The current range
+    unsigned int m_first;
+    unsigned int m_last;
+
+
+    /// Number of bands of the current range
+    unsigned int m_band_count;
+
+
+    /// The first error thrown by a task
+    std::exception_ptr m_error;
+};
+
+#endif
@@ -0,0 +1,405 @@
+/**
+********************************************************************************
+*
+*   @file       BufferPool.cpp
+*
+*   @brief      Class to recycle the pixel buffers of the images.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "BufferPool.h"
+
+
+//******************************************************************************
+//  Global variables
+//******************************************************************************
+
+/// Number of floats of the smallest size class
+static const std::size_t g_min_capacity(64);
+
+
+/// Number of size classes (4 per power of two, from 256 B to 15 GB)
+static const unsigned int g_class_count(4 * 26);
+
+
+/// Number of buffers of every class kept by a thread
+static const unsigned int g_thread_buffer_count(2);
+
+
+/// Larger buffers are only kept in the shared cache
+static const std::size_t g_thread_max_bytes(std::size_t(1) << 22);
+
+
+//==============================================================================
+/**
+*   @class  SharedCache
+*   @brief  Buffers shared by the threads, and the statistics of the pool.
+*/
+//==============================================================================
+struct SharedCache
+//------------------------------------------------------------------------------
+{
+    SharedCache():
+            m_byte_count(0),
+            m_byte_limit(std::size_t(256) << 20),
+            m_hit_count(0),
+            m_miss_count(0),
+            m_used_bytes(0),
+            m_cached_bytes(0),
+            m_peak_bytes(0)
+    {}
+
+
+    /// Protect m_buffer_set, m_byte_count and m_byte_limit
+    std::mutex m_mutex;
+
+
+    /// The free buffers of every class
+    std::vector<float*> m_buffer_set[g_class_count];
+
+
+    /// Number of bytes in m_buffer_set
+    std::size_t m_byte_count;
+
+
+    /// Largest value of m_byte_count
+    std::size_t m_byte_limit;
+
+
+    /// Statistics (the caches of the threads included)
+    std::atomic<unsigned long long> m_hit_count;
+    std::atomic<unsigned long long> m_miss_count;
+    std::atomic<std::size_t> m_used_bytes;
+    std::atomic<std::size_t> m_cached_bytes;
+    std::atomic<std::size_t> m_peak_bytes;
+};
+
+
+//==============================================================================
+/**
+*   @class  ThreadCache
+*   @brief  Buffers kept by a thread, accessed without any lock. They go to
+*           the shared cache when the thread exits.
+*/
+//==============================================================================
+struct ThreadCache
+//------------------------------------------------------------------------------
+{
+    ThreadCache();
+    ~ThreadCache();
+
+
+    /// The free buffers of every class
+    float* m_buffer_set[g_class_count][g_thread_buffer_count];
+
+
+    /// Number of buffers of every class
+    unsigned int m_count_set[g_class_count];
+};
+
+
+/// The cache of the current thread
+static thread_local ThreadCache g_thread_cache;
+
+
+/// The cache of the current thread has been destroyed (images released
+/// during the destruction of the static objects use the shared cache)
+static thread_local bool g_is_thread_cache_destroyed(false);
+
+
+//******************************************************************************
+//  Functions
+//******************************************************************************
+
+//-------------------------------------------------
+static std::size_t getCapacity(unsigned int aClass)
+//-------------------------------------------------
+{
+    return ((g_min_capacity << (aClass / 4)) / 4 * (4 + aClass % 4));
+}
+
+
+//---------------------------------------------
+static unsigned int getClass(std::size_t aSize)
+//---------------------------------------------
+{
+    // g_class_count if the buffer is not pooled
+    unsigned int size_class(0);
+    while (size_class < g_class_count && getCapacity(size_class) < aSize)
+    {
+        ++size_class;
+    }
+
+    return (size_class);
+}
+
+
+//----------------------------------
+static SharedCache& getSharedCache()
+//----------------------------------
+{
+    // Never destroyed: threads may release buffers during the destruction of
+    // the static objects
+    static SharedCache* p_shared_cache(new SharedCache);
+
+    return (*p_shared_cache);
+}
+
+
+//----------------------------------
+static ThreadCache* getThreadCache()
+//----------------------------------
+{
+    if (g_is_thread_cache_destroyed)
+    {
+        return (0);
+    }
+
+    return (&g_thread_cache);
+}
+
+
+//-------------------------------------------------------------
+static void releaseShared(unsigned int aClass, float* apBuffer)
+//-------------------------------------------------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+    const std::size_t byte_count(getCapacity(aClass) * sizeof(float));
+
+    // Keep the buffer
+    {
+        std::lock_guard<std::mutex> lock(shared_cache.m_mutex);
+        if (shared_cache.m_byte_count + byte_count <= shared_cache.m_byte_limit)
+        {
+            shared_cache.m_buffer_set[aClass].push_back(apBuffer);
+            shared_cache.m_byte_count += byte_count;
+            return;
+        }
+    }
+
+    // The cache is full
+    delete [] apBuffer;
+    shared_cache.m_cached_bytes -= byte_count;
+}
+
+
+//------------------------
+ThreadCache::ThreadCache()
+//------------------------
+{
+    for (unsigned int i(0); i < g_class_count; ++i)
+    {
+        m_count_set[i] = 0;
+    }
+}
+
+
+//-------------------------
+ThreadCache::~ThreadCache()
+//-------------------------
+{
+    g_is_thread_cache_destroyed = true;
+
+    // Give the buffers to the other threads
+    for (unsigned int i(0); i < g_class_count; ++i)
+    {
+        while (m_count_set[i])
+        {
+            releaseShared(i, m_buffer_set[i][--m_count_set[i]]);
+        }
+    }
+}
+
+
+//--------------------------------------------
+float* BufferPool::allocate(std::size_t aSize)
+//--------------------------------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+    const unsigned int size_class(getClass(aSize));
+
+    // Too large for the size classes
+    const std::size_t capacity(size_class < g_class_count ? getCapacity(size_class) : aSize);
+    const std::size_t byte_count(capacity * sizeof(float));
+
+    float* p_buffer(0);
+    if (size_class < g_class_count)
+    {
+        // Look in the cache of the thread, then in the shared one
+        ThreadCache* p_thread_cache(getThreadCache());
+        if (p_thread_cache && p_thread_cache->m_count_set[size_class])
+        {
+            p_buffer = p_thread_cache->m_buffer_set[size_class][--p_thread_cache->m_count_set[size_class]];
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(shared_cache.m_mutex);
+            std::vector<float*>& buffer_set(shared_cache.m_buffer_set[size_class]);
+            if (!buffer_set.empty())
+            {
+                p_buffer = buffer_set.back();
+                buffer_set.pop_back();
+                shared_cache.m_byte_count -= byte_count;
+            }
+        }
+    }
+
+    // Hit: the buffer moves from the cache to the used buffers
+    if (p_buffer)
+    {
+        ++shared_cache.m_hit_count;
+        shared_cache.m_cached_bytes -= byte_count;
+        shared_cache.m_used_bytes += byte_count;
+    }
+    // Miss: the memory held by the pool grows
+    else
+    {
+        p_buffer = new float[capacity];
+
+        ++shared_cache.m_miss_count;
+        const std::size_t total(shared_cache.m_used_bytes += byte_count);
+        const std::size_t peak(total + shared_cache.m_cached_bytes);
+        std::size_t previous_peak(shared_cache.m_peak_bytes);
+        while (previous_peak < peak && !shared_cache.m_peak_bytes.compare_exchange_weak(previous_peak, peak))
+        {
+        }
+    }
+
+    return (p_buffer);
+}
+
+
+//----------------------------------------------------------
+void BufferPool::release(float* apBuffer, std::size_t aSize)
+//----------------------------------------------------------
+{
+    if (!apBuffer)
+    {
+        return;
+    }
+
+    SharedCache& shared_cache(getSharedCache());
+    const unsigned int size_class(getClass(aSize));
+
+    // Not pooled
+    if (size_class == g_class_count)
+    {
+        delete [] apBuffer;
+        shared_cache.m_used_bytes -= aSize * sizeof(float);
+        return;
+    }
+
+    const std::size_t byte_count(getCapacity(size_class) * sizeof(float));
+    shared_cache.m_used_bytes -= byte_count;
+    shared_cache.m_cached_bytes += byte_count;
+
+    // Keep the buffer in the cache of the thread if there is room
+    ThreadCache* p_thread_cache(getThreadCache());
+    if (p_thread_cache &&
+            byte_count <= g_thread_max_bytes &&
+            p_thread_cache->m_count_set[size_class] < g_thread_buffer_count)
+    {
+        p_thread_cache->m_buffer_set[size_class][p_thread_cache->m_count_set[size_class]++] = apBuffer;
+    }
+    else
+    {
+        releaseShared(size_class, apBuffer);
+    }
+}
+
+
+//------------------------------------------------
+BufferPool::Statistics BufferPool::getStatistics()
+//------------------------------------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+
+    Statistics statistics;
+    statistics.m_hit_count = shared_cache.m_hit_count;
+    statistics.m_miss_count = shared_cache.m_miss_count;
+    statistics.m_used_bytes = shared_cache.m_used_bytes;
+    statistics.m_cached_bytes = shared_cache.m_cached_bytes;
+    statistics.m_peak_bytes = shared_cache.m_peak_bytes;
+
+    return (statistics);
+}
+
+
+//--------------------------------
+void BufferPool::resetStatistics()
+//--------------------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+
+    shared_cache.m_hit_count = 0;
+    shared_cache.m_miss_count = 0;
+    shared_cache.m_peak_bytes = shared_cache.m_used_bytes + shared_cache.m_cached_bytes;
+}
+
+
+//----------------------------------------------------
+void BufferPool::setCacheLimit(std::size_t aByteCount)
+//----------------------------------------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+
+    std::lock_guard<std::mutex> lock(shared_cache.m_mutex);
+    shared_cache.m_byte_limit = aByteCount;
+}
+
+
+//----------------------
+void BufferPool::clear()
+//----------------------
+{
+    SharedCache& shared_cache(getSharedCache());
+    std::size_t byte_count(0);
+
+    // The cache of the thread
+    ThreadCache* p_thread_cache(getThreadCache());
+    if (p_thread_cache)
+    {
+        for (unsigned int i(0); i < g_class_count; ++i)
+        {
+            while (p_thread_cache->m_count_set[i])
+            {
+                delete [] p_thread_cache->m_buffer_set[i][--p_thread_cache->m_count_set[i]];
+                byte_count += getCapacity(i) * sizeof(float);
+            }
+        }
+    }
+
+    // The shared cache
+    {
+        std::lock_guard<std::mutex> lock(shared_cache.m_mutex);
+        for (unsigned int i(0); i < g_class_count; ++i)
+        {
+            std::vector<float*>& buffer_set(shared_cache.m_buffer_set[i]);
+            for (unsigned int j(0); j < buffer_set.size(); ++j)
+            {
+                delete [] buffer_set[j];
+            }
+            buffer_set.clear();
+        }
+        byte_count += shared_cache.m_byte_count;
+        shared_cache.m_byte_count = 0;
+    }
+
+    shared_cache.m_cached_bytes -= byte_count;
+}
@@ -0,0 +1,212 @@
+/**
+********************************************************************************
+*
+*   @file       FFT.cpp
+*
+*   @brief      Class to compute fast Fourier transforms of square tiles.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <cmath> // Header file for cos/sin
+#include <algorithm> // Header file for swap
+
+#include "FFT.h"
+
+
+//******************************************************************************
+//  Constant
+//******************************************************************************
+static const double PI(3.14159265358979323846);
+
+
+//----------------------------
+FFT::FFT(unsigned int aSize):
+//----------------------------
+        m_size(aSize),
+        m_twiddle_set(aSize / 2),
+        m_reversed_index_set(aSize)
+//----------------------------
+{
+    // The size must be a power of two
+    if (!aSize || (aSize & (aSize - 1)))
+    {
+        throw "The size of a FFT must be a power of two";
+    }
+
+    // Twiddle factors
+    for (unsigned int k(0); k < m_size / 2; ++k)
+    {
+        const double angle(-2.0 * PI * k / m_size);
+        m_twiddle_set[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+
+    // Bit-reversal permutation
+    unsigned int bit_count(0);
+    while ((1u << bit_count) < m_size)
+    {
+        ++bit_count;
+    }
+
+    for (unsigned int i(0); i < m_size; ++i)
+    {
+        unsigned int reversed(0);
+        for (unsigned int bit(0); bit < bit_count; ++bit)
+        {
+            if (i & (1u << bit))
+            {
+                reversed |= 1u << (bit_count - 1 - bit);
+            }
+        }
+        m_reversed_index_set[i] = reversed;
+    }
+}
+
+
+//-------------------------------
+unsigned int FFT::getSize() const
+//-------------------------------
+{
+    return (m_size);
+}
+
+
+//-----------------------------------------------------
+unsigned int FFT::getPowerOfTwo(unsigned int aValue)
+//-----------------------------------------------------
+{
+    unsigned int power_of_two(1);
+    while (power_of_two < aValue)
+    {
+        power_of_two <<= 1;
+    }
+
+    return (power_of_two);
+}
+
+
+//------------------------------------------------------------
+void FFT::forward(Complex* apData, unsigned int aStride) const
+//------------------------------------------------------------
+{
+    transform(apData, aStride, false);
+}
+
+
+//------------------------------------------------------------
+void FFT::inverse(Complex* apData, unsigned int aStride) const
+//------------------------------------------------------------
+{
+    transform(apData, aStride, true);
+
+    const double scale(1.0 / m_size);
+    for (unsigned int i(0); i < m_size; ++i)
+    {
+        apData[i * aStride] *= scale;
+    }
+}
+
+
+//-------------------------------------------
+void FFT::forward2D(Complex* apData) const
+//-------------------------------------------
+{
+    transform2D(apData, false);
+}
+
+
+//-------------------------------------------
+void FFT::inverse2D(Complex* apData) const
+//-------------------------------------------
+{
+    transform2D(apData, true);
+
+    const double scale(1.0 / (double(m_size) * m_size));
+    for (unsigned int i(0); i < m_size * m_size; ++i)
+    {
+        apData[i] *= scale;
+    }
+}
+
+
+//-------------------------------------------------------------------------------
+void FFT::transform(Complex* apData, unsigned int aStride, bool anInverseFlag) const
+//-------------------------------------------------------------------------------
+{
+    // Reorder the samples
+    for (unsigned int i(0); i < m_size; ++i)
+    {
+        const unsigned int j(m_reversed_index_set[i]);
+        if (i < j)
+        {
+            std::swap(apData[i * aStride], apData[j * aStride]);
+        }
+    }
+
+    // Butterflies of increasing size
+    for (unsigned int half_size(1); half_size < m_size; half_size <<= 1)
+    {
+        const unsigned int twiddle_step(m_size / (2 * half_size));
+
+        for (unsigned int start(0); start < m_size; start += 2 * half_size)
+        {
+            for (unsigned int k(0); k < half_size; ++k)
+            {
+                Complex twiddle(m_twiddle_set[k * twiddle_step]);
+                if (anInverseFlag)
+                {
+                    twiddle = std::conj(twiddle);
+                }
+
+                Complex& even(apData[(start + k) * aStride]);
+                Complex& odd(apData[(start + k + half_size) * aStride]);
+
+                // Plain complex product (no special handling of NaN/inf)
+                const Complex product(odd.real() * twiddle.real() - odd.imag() * twiddle.imag(),
+                                      odd.real() * twiddle.imag() + odd.imag() * twiddle.real());
+                odd  = even - product;
+                even = even + product;
+            }
+        }
+    }
+}
+
+
+//---------------------------------------------------------------------
+void FFT::transform2D(Complex* apData, bool anInverseFlag) const
+//---------------------------------------------------------------------
+{
+    // Every row
+    for (unsigned int j(0); j < m_size; ++j)
+    {
+        transform(apData + j * m_size, 1, anInverseFlag);
+    }
+
+    // Every column, copied into a contiguous buffer
+    std::vector<Complex> column(m_size);
+    for (unsigned int i(0); i < m_size; ++i)
+    {
+        for (unsigned int j(0); j < m_size; ++j)
+        {
+            column[j] = apData[j * m_size + i];
+        }
+
+        transform(&column[0], 1, anInverseFlag);
+
+        for (unsigned int j(0); j < m_size; ++j)
+        {
+            apData[j * m_size + i] = column[j];
+        }
+    }
+}
@@ -17,12 +17,6 @@
 */
 
 
-//******************************************************************************
-//  Define
-//******************************************************************************
-#define LINE_SIZE 2048
-
-
 //******************************************************************************
 //  Include
 //******************************************************************************
@@ -32,36 +26,367 @@
 #include <cmath> // Header file for abs
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <limits> // Header file for numeric_limits
+#include <utility> // Header file for move/swap
+#include <cstdint> // Header file for uintptr_t
 
 #include "Image.h"
+#include "MappedFile.h"
+#include "PixelImage.h"
+#include "ThreadPool.h"
+#include "BufferPool.h"
+#include "RowKernels.h"
+#include "FFT.h"
 
 
-//------------------
-Image::Image():
-//------------------
+//******************************************************************************
+//  Global variables
+//******************************************************************************
+
+/// Worker threads shared by the filters
+static std::unique_ptr<ThreadPool> g_p_thread_pool;
+
+
+/// Alignment of the rows with the aligned storage: a 64-byte cache line
+static const unsigned int g_row_alignment(64 / sizeof(float));
+
+
+/// 3x3 kernels (row-major order) and their normalisation factors
+static const float g_laplacian_kernel[9] = { 0, 1, 0, 1, -4, 1, 0, 1, 0 };
+static const float g_gaussian_kernel[9] = { 1, 2, 1, 2, 4, 2, 1, 2, 1 };
+static const float g_box_kernel[9] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+static const float g_sharpen_kernel[9] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+static const float g_gaussian_divisor(16);
+static const float g_box_divisor(9);
+
+
+//==============================================================================
+/**
+*   @class  PixelRowKernel
+*   @brief  Row kernel calling a per-pixel function of Image on every pixel
+*/
+//==============================================================================
+template<typename Kernel> class PixelRowKernel
+//------------------------------------------------------------------------------
+{
+public:
+	PixelRowKernel(Image& anImage, Kernel aKernel):
+		m_image(anImage),
+		m_kernel(aKernel)
+	{}
+
+
+	void operator()(const float* apAbove,
+		const float* apRow,
+		const float* apBelow,
+		float* apOutput,
+		unsigned int aCount) const
+	{
+		for (unsigned int i(0); i < aCount; ++i)
+		{
+			const float* p_above(apAbove + i);
+			const float* p_row(apRow + i);
+			const float* p_below(apBelow + i);
+
+			apOutput[i] = (m_image.*m_kernel)(
+				p_above[-1], p_above[0], p_above[1],
+				p_row[-1],   p_row[0],   p_row[1],
+				p_below[-1], p_below[0], p_below[1]);
+		}
+	}
+
+
+private:
+	Image& m_image;
+	Kernel m_kernel;
+};
+
+
+//----------------------------------------------------------------
+template<typename Kernel> PixelRowKernel<Kernel> getPixelRowKernel(Image& anImage, Kernel aKernel)
+//----------------------------------------------------------------
+{
+	return (PixelRowKernel<Kernel>(anImage, aKernel));
+}
+
+
+//==============================================================================
+/**
+*   @class  MedianRowKernel
+*   @brief  Row kernel computing the 3x3 median with SIMD instructions
+*/
+//==============================================================================
+class MedianRowKernel
+//------------------------------------------------------------------------------
+{
+public:
+	void operator()(const float* apAbove,
+		const float* apRow,
+		const float* apBelow,
+		float* apOutput,
+		unsigned int aCount) const
+	{
+		RowKernels::median_3x3(apAbove, apRow, apBelow, apOutput, aCount);
+	}
+};
+
+
+//==============================================================================
+/**
+*   @class  LinearRowKernel
+*   @brief  Row kernel applying a weighted 3x3 kernel with SIMD instructions
+*/
+//==============================================================================
+class LinearRowKernel
+//------------------------------------------------------------------------------
+{
+public:
+	LinearRowKernel(const float* apKernel, float aDivisor = 1):
+		m_p_kernel(apKernel),
+		m_divisor(aDivisor)
+	{}
+
+
+	void operator()(const float* apAbove,
+		const float* apRow,
+		const float* apBelow,
+		float* apOutput,
+		unsigned int aCount) const
+	{
+		RowKernels::convolve_3x3(apAbove, apRow, apBelow, apOutput, aCount, m_p_kernel, m_divisor);
+	}
+
+
+private:
+	const float* m_p_kernel;
+	float m_divisor;
+};
+
+
+//==============================================================================
+/**
+*   @class  GradientRowKernel
+*   @brief  Row kernel computing the L1 magnitude of a gradient operator
+*           with SIMD instructions
+*/
+//==============================================================================
+class GradientRowKernel
+//------------------------------------------------------------------------------
+{
+public:
+	GradientRowKernel(RowKernels::GradientOperator anOperator):
+		m_operator(anOperator)
+	{}
+
+
+	void operator()(const float* apAbove,
+		const float* apRow,
+		const float* apBelow,
+		float* apOutput,
+		unsigned int aCount) const
+	{
+		const RowKernels::GradientOutput output = { m_operator, apOutput, 0 };
+		RowKernels::gradient_3x3(apAbove, apRow, apBelow, &output, 1, 0, aCount, false);
+	}
+
+
+private:
+	RowKernels::GradientOperator m_operator;
+};
+
+
+//----------------------------------------------------------------
+/// Check if writing anOutput pixel by pixel could overwrite pixels of
+/// anInput before they are read, i.e. if they share pixels that are not
+/// at the same position in both.
+//----------------------------------------------------------------
+static bool isAliasing(const ImageView& anInput, const ImageView& anOutput)
+//----------------------------------------------------------------
+{
+	return (anInput.isOverlapping(anOutput) &&
+		(anInput.getRow(0) != anOutput.getRow(0) ||
+		anInput.getStride() != anOutput.getStride() ||
+		anInput.getWidth() != anOutput.getWidth() ||
+		anInput.getHeight() != anOutput.getHeight()));
+}
+
+
+//----------------------
+ImageView::ImageView():
+//----------------------
         m_width(0),
         m_height(0),
-        m_p_image(0)
-//------------------
+        m_stride(0),
+        m_p_image(0),
+        m_halo_size(0),
+        m_halo_mode(BORDER_REPLICATE),
+        m_halo_value(0)
+//----------------------
 {}
 
 
 //----------------------------------------------
-Image::Image(const Image& anImage):
+ImageView::ImageView(const float* apData,
+                     unsigned int aWidth,
+                     unsigned int aHeight,
+                     unsigned int aStride):
 //----------------------------------------------
+        m_width(aWidth),
+        m_height(aHeight),
+        m_stride(aStride ? aStride : aWidth),
+        // The pixels are only read through a view
+        m_p_image(const_cast<float*>(apData)),
+        m_halo_size(0),
+        m_halo_mode(BORDER_REPLICATE),
+        m_halo_value(0)
+//----------------------------------------------
+{
+    // The rows would overlap
+    if (m_stride < m_width)
+    {
+        throw "The stride of a view is smaller than its width";
+    }
+}
+
+
+//---------------------------------------------
+ImageView::ImageView(const ImageView& anImage):
+//---------------------------------------------
         m_width(anImage.m_width),
         m_height(anImage.m_height),
-        m_p_image(new float[m_width * m_height])
-//----------------------------------------------
+        m_stride(anImage.m_stride),
+        m_p_image(anImage.m_p_image),
+        // The halo may become stale when the image is modified
+        m_halo_size(0),
+        m_halo_mode(BORDER_REPLICATE),
+        m_halo_value(0)
+//---------------------------------------------
+{}
+
+
+//-------------------------------------------------------
+ImageView& ImageView::operator=(const ImageView& anImage)
+//-------------------------------------------------------
 {
-    // Out of memeory
-    if (m_width && m_height && !m_p_image)
+    m_width = anImage.m_width;
+    m_height = anImage.m_height;
+    m_stride = anImage.m_stride;
+    m_p_image = anImage.m_p_image;
+
+    // The halo may become stale when the image is modified
+    m_halo_size = 0;
+
+    return (*this);
+}
+
+
+//------------------------------------------------------
+ImageView ImageView::getView(unsigned int i,
+                             unsigned int j,
+                             unsigned int aWidth,
+                             unsigned int aHeight) const
+//------------------------------------------------------
+{
+    // The ROI is not inside of the view
+    if (i > m_width || aWidth > m_width - i || j > m_height || aHeight > m_height - j)
     {
-        throw "Out of memory";
+        throw "Invalid region of interest";
     }
-    
+
+    return (ImageView(m_p_image + j * m_stride + i, aWidth, aHeight, m_stride));
+}
+
+
+//---------------------------------------
+unsigned int ImageView::getStride() const
+//---------------------------------------
+{
+    return (m_stride);
+}
+
+
+//----------------------------------------------------
+const float* ImageView::getRow(unsigned int j) const
+//----------------------------------------------------
+{
+    return (m_p_image + j * m_stride);
+}
+
+
+//-------------------------------------------------------------------
+bool ImageView::isOverlapping(const ImageView& anImage) const
+//-------------------------------------------------------------------
+{
+    // An empty view has no pixel
+    if (!m_width || !m_height || !anImage.m_width || !anImage.m_height)
+    {
+        return (false);
+    }
+
+    // The memory spanned by both views intersect
+    const float* p_end(m_p_image + (m_height - 1) * m_stride + m_width);
+    const float* p_other_end(anImage.m_p_image + (anImage.m_height - 1) * anImage.m_stride + anImage.m_width);
+
+    return (m_p_image < p_other_end && anImage.m_p_image < p_end);
+}
+
+
+//------------------
+Image::Image():
+//------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
+//------------------
+{}
+
+
+//----------------------------------------------
+Image::Image(const Image& anImage):
+//----------------------------------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(anImage.m_aligned_flag),
+        m_halo_capacity(anImage.m_halo_capacity)
+//----------------------------------------------
+{
+    // Copy the data
+    copy(anImage);
+}
+
+
+//----------------------------------------------
+Image::Image(const ImageView& anImage):
+//----------------------------------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
+//----------------------------------------------
+{
     // Copy the data
-    std::copy(anImage.m_p_image, anImage.m_p_image + m_width * m_height, m_p_image);
+    copy(anImage);
+}
+
+
+//----------------------------------------------
+Image::Image(Image&& anImage) noexcept:
+//----------------------------------------------
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
+//----------------------------------------------
+{
+    // The other image no longer owns the data
+    swap(anImage);
 }
 
 
@@ -70,19 +395,15 @@ Image::Image(const float* apData,
              unsigned int aWidth,
              unsigned int aHeight):
 //----------------------------------------------
-        m_width(aWidth),
-        m_height(aHeight),
-        m_p_image(new float[m_width * m_height])
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
 //----------------------------------------------
 {
-    // Out of memeory
-    if (m_width && m_height && !m_p_image)
-    {
-        throw "Out of memory";
-    }
-
     // Copy the data
-    std::copy(apData, apData + m_width * m_height, m_p_image);
+    copy(ImageView(apData, aWidth, aHeight));
 }
 
 
@@ -90,19 +411,20 @@ Image::Image(const float* apData,
 Image::Image(unsigned int aWidth,
              unsigned int aHeight):
 //----------------------------------------------
-        m_width(aWidth),
-        m_height(aHeight),
-        m_p_image(new float[m_width * m_height])
+        ImageView(),
+        m_p_buffer(0),
+        m_buffer_size(0),
+        m_aligned_flag(false),
+        m_halo_capacity(0)
 //----------------------------------------------
 {
-    // Out of memeory
-    if (m_width && m_height && !m_p_image)
-    {
-        throw "Out of memory";
-    }
+    setSize(aWidth, aHeight);
 
     // Initialise the data
-    std::fill_n(m_p_image, m_width * m_height, 0);
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        std::fill_n(getRow(j), m_width, 0);
+    }
 }
 
 
@@ -120,23 +442,115 @@ void Image::destroy()
 //-------------------
 {
     // Memory has been dynamically allocated
-    if (m_p_image)
+    if (m_p_buffer)
     {
-        // Release the memory
-        delete [] m_p_image;
+        // Give the memory back to the pool
+        BufferPool::release(m_p_buffer, m_buffer_size);
     
-        // Make sure the pointer is reset to NULL
+        // Make sure the pointers are reset to NULL
+        m_p_buffer = 0;
         m_p_image = 0;
     }
     
     // There is no pixel in the image
+    m_buffer_size = 0;
     m_width  = 0;
     m_height = 0;
+    m_stride = 0;
+    m_halo_size = 0;
+}
+
+
+//-----------------------------------------------------
+void Image::setAlignedStorage(unsigned int aHaloSize)
+//-----------------------------------------------------
+{
+    setStorage(true, aHaloSize);
+}
+
+
+//----------------------------
+void Image::setPackedStorage()
+//----------------------------
+{
+    setStorage(false, 0);
+}
+
+
+//----------------------------
+bool Image::isAligned() const
+//----------------------------
+{
+    return (m_aligned_flag);
+}
+
+
+//--------------------------------------
+unsigned int Image::getHaloSize() const
+//--------------------------------------
+{
+    return (m_halo_capacity);
+}
+
+
+//----------------------------------------------------------------------
+void Image::fillHalo(BorderMode aBorderMode, float aBorderValue)
+//----------------------------------------------------------------------
+{
+    // No pixel to read the border from
+    if (!m_width || !m_height)
+    {
+        return;
+    }
+
+    const int halo(m_halo_capacity);
+    const int width(m_width);
+    const int height(m_height);
+
+    for (int j(-halo); j < height + halo; ++j)
+    {
+        float* p_row(m_p_image + j * int(m_stride));
+
+        // Row of the image: only the pixels on the sides are missing
+        if (j >= 0 && j < height)
+        {
+            for (int i(1); i <= halo; ++i)
+            {
+                p_row[-i] = getBorderPixel(-i, j, aBorderMode, aBorderValue);
+                p_row[width - 1 + i] = getBorderPixel(width - 1 + i, j, aBorderMode, aBorderValue);
+            }
+        }
+        // Row above or below the image
+        else
+        {
+            for (int i(-halo); i < width + halo; ++i)
+            {
+                p_row[i] = getBorderPixel(i, j, aBorderMode, aBorderValue);
+            }
+        }
+    }
+
+    // The filters using the same border can read the halo
+    m_halo_size = m_halo_capacity;
+    m_halo_mode = aBorderMode;
+    m_halo_value = aBorderValue;
+}
+
+
+//----------------------------------
+float* Image::getRow(unsigned int j)
+//----------------------------------
+{
+    // The pixels may be written through the pointer: the halo is not valid
+    // any more
+    m_halo_size = 0;
+
+    return (m_p_image + j * m_stride);
 }
 
 
 //---------------------------------------------
-Image Image::getROI(unsigned int i,
+Image ImageView::getROI(unsigned int i,
                     unsigned int j,
                     unsigned int aWidth,
                     unsigned int aHeight) const
@@ -145,24 +559,15 @@ Image Image::getROI(unsigned int i,
     // Create a black image
     Image roi(aWidth, aHeight);
 
-    // Process every row of the ROI
-    for (unsigned y(0); y < aHeight; ++y)
+    // Copy the part of every row that is inside of the current view
+    if (i < m_width)
     {
-        // Process every column of the ROI
-        for (unsigned x(0); x < aWidth; ++x)
-        {
-            unsigned int index_i(x + i);
-            unsigned int index_j(y +j);
-
-            // The pixel index is valid
-            if ((index_i < m_width) && (index_j < m_height))
-            {
-                // Get the pixel intensity from the current instance
-                float intensity(getPixel(index_i, index_j));
+        const unsigned int width(std::min(aWidth, m_width - i));
 
-                // Set the pixel of the ROI
-                roi.setPixel(x, y, intensity);
-            }
+        for (unsigned int y(0); y < aHeight && j + y < m_height; ++y)
+        {
+            const float* p_row(getRow(j + y) + i);
+            std::copy(p_row, p_row + width, roi.getRow(y));
         }
     }
     
@@ -182,13 +587,14 @@ void Image::setPixel(unsigned int i, unsigned int j, float aValue)
     }
     
     // Change the pixel value
-    m_p_image[j * m_width + i] = aValue;
+    m_p_image[j * m_stride + i] = aValue;
+    m_halo_size = 0;
 }
 
 
-//---------------------------------------------------------
-float Image::getPixel(unsigned int i, unsigned int j) const
-//---------------------------------------------------------
+//-------------------------------------------------------------
+float ImageView::getPixel(unsigned int i, unsigned int j) const
+//-------------------------------------------------------------
 {
 	//std::cout << "i " << i;
 	//std::cout << " j " << j << std::endl;
@@ -201,12 +607,12 @@ float Image::getPixel(unsigned int i, unsigned int j) const
     }
     
     // Return the pixel value
-    return (m_p_image[j * m_width + i]);
+    return (m_p_image[j * m_stride + i]);
 }
 
-//------------------------------------------------
-bool Image::operator!=(const Image& anImage) const
-//------------------------------------------------
+//--------------------------------------------------------
+bool ImageView::operator!=(const ImageView& anImage) const
+//--------------------------------------------------------
 {
 	return (!(operator==(anImage)));
 }
@@ -214,6 +620,22 @@ bool Image::operator!=(const Image& anImage) const
 //-------------------------------------------
 Image& Image::operator=(const Image& anImage)
 //-------------------------------------------
+{
+    // The images different
+    if (this != &anImage)
+    {
+        // Copy the data (the buffer is reused if possible)
+        copy(anImage);
+    }
+
+    // Return the instance
+    return (*this);
+}
+
+
+//-----------------------------------------------
+Image& Image::operator=(Image&& anImage) noexcept
+//-----------------------------------------------
 {
     // The images different
     if (this != &anImage)
@@ -221,19 +643,8 @@ Image& Image::operator=(const Image& anImage)
         // Release memory
         destroy();
 
-        // Copy the image properites
-        m_width   = anImage.m_width;
-        m_height  = anImage.m_height;
-        m_p_image = new float[m_width * m_height];
-
-        // Out of memeory
-        if (m_width && m_height && !m_p_image)
-        {
-            throw "Out of memory";
-        }
-        
-        // Copy the data
-        std::copy(anImage.m_p_image, anImage.m_p_image + m_width * m_height, m_p_image);
+        // Take the data of the other image
+        swap(anImage);
     }
 
     // Return the instance
@@ -241,167 +652,69 @@ Image& Image::operator=(const Image& anImage)
 }
 
 
-//------------------------------------------
-Image Image::operator+(const Image& anImage)
-//------------------------------------------
+//----------------------------------------
+void Image::swap(Image& anImage) noexcept
+//----------------------------------------
 {
-    // Deal with images of different sizes
-    unsigned int min_width(std::min(m_width, anImage.m_width));
-    unsigned int min_height(std::min(m_height, anImage.m_height));
-    
-    // Copy the instance into a temporary variable
-    Image temp(getROI(0, 0, min_width, min_height));
-    
-    // Copy the data
-    for (unsigned int j(0); j < min_height; ++j)
-    {
-        for (unsigned int i(0); i < min_width; ++i)
-        {
-            temp.m_p_image[j * temp.m_width + i] += anImage.m_p_image[j * anImage.m_width + i];
-        }
-    }
-    
-    // Return the result
-    return (temp);
+    std::swap(m_width, anImage.m_width);
+    std::swap(m_height, anImage.m_height);
+    std::swap(m_stride, anImage.m_stride);
+    std::swap(m_p_image, anImage.m_p_image);
+    std::swap(m_halo_size, anImage.m_halo_size);
+    std::swap(m_halo_mode, anImage.m_halo_mode);
+    std::swap(m_halo_value, anImage.m_halo_value);
+    std::swap(m_p_buffer, anImage.m_p_buffer);
+    std::swap(m_buffer_size, anImage.m_buffer_size);
+    std::swap(m_aligned_flag, anImage.m_aligned_flag);
+    std::swap(m_halo_capacity, anImage.m_halo_capacity);
 }
 
 
-//------------------------------------------
-Image Image::operator-(const Image& anImage)
-//------------------------------------------
+//----------------------------------------------
+void swap(Image& anImage1, Image& anImage2) noexcept
+//----------------------------------------------
 {
-    // Deal with images of different sizes
-    unsigned int min_width(std::min(m_width, anImage.m_width));
-    unsigned int min_height(std::min(m_height, anImage.m_height));
-    
-    // Copy the instance into a temporary variable
-    Image temp(getROI(0, 0, min_width, min_height));
-    
-    // Copy the data
-    for (unsigned int j(0); j < min_height; ++j)
-    {
-        for (unsigned int i(0); i < min_width; ++i)
-        {
-            temp.m_p_image[j * temp.m_width + i] -= anImage.m_p_image[j * anImage.m_width + i];
-        }
-    }
-    
-    // Return the result
-    return (temp);
+    anImage1.swap(anImage2);
 }
 
 
-//--------------------------------------------
-Image& Image::operator+=(const Image& anImage)
-//--------------------------------------------
+//------------------------------------------------
+Image& Image::operator+=(const ImageView& anImage)
+//------------------------------------------------
 {
-    // Re-use operator+
-    *this = *this + anImage;
+    // A weight of 1 gives the exact sum
+    accumulate(anImage, 1.0f);
     
     // Return the result
     return (*this);
 }
 
 
-//--------------------------------------------
-Image& Image::operator-=(const Image& anImage)
-//--------------------------------------------
+//------------------------------------------------
+Image& Image::operator-=(const ImageView& anImage)
+//------------------------------------------------
 {
-    // Re-use operator-
-    *this = *this - anImage;
+    // A weight of -1 gives the exact difference
+    accumulate(anImage, -1.0f);
     
     // Return the result
     return (*this);
 }
 
 
-//----------------------------------
-Image Image::operator+(float aValue)
-//----------------------------------
-{
-    // Copy the instance into a temporary variable
-    Image temp(*this);
-
-    float* p_temp(temp.m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        *p_temp++ += aValue;
-    }
-    
-    // Return the result
-    return (temp);
-}
-
-
-//----------------------------------
-Image Image::operator-(float aValue)
-//----------------------------------
-{
-    // Copy the instance into a temporary variable
-    Image temp(*this);
-
-    float* p_temp(temp.m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        *p_temp++ -= aValue;
-    }
-    
-    // Return the result
-    return (temp);
-}
-
-
-//----------------------------------
-Image Image::operator*(float aValue)
-//----------------------------------
-{
-    // Copy the instance into a temporary variable
-    Image temp(*this);
-
-    float* p_temp(temp.m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        *p_temp++ *= aValue;
-    }
-    
-    // Return the result
-    return (temp);
-}
-
-
-//----------------------------------
-Image Image::operator/(float aValue)
-//----------------------------------
-{
-    // Division by zero
-    if (std::abs(aValue) < 1.0e-6)
-    {
-        throw "Division by zero.";
-    }
-    
-    // Copy the instance into a temporary variable
-    Image temp(*this);
-
-    float* p_temp(temp.m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        *p_temp++ /= aValue;
-    }
-    
-    // Return the result
-    return (temp);
-}
-
-
 //-----------------------------------
 Image& Image::operator+=(float aValue)
 //-----------------------------------
 {
-    float* p_temp(m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
+    for (unsigned int j(0); j < m_height; ++j)
     {
-        *p_temp++ += aValue;
+        float* p_temp(getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            *p_temp++ += aValue;
+        }
     }
+    m_halo_size = 0;
     
     // Return the result
     return (*this);
@@ -412,11 +725,15 @@ Image& Image::operator+=(float aValue)
 Image& Image::operator-=(float aValue)
 //------------------------------------
 {
-    float* p_temp(m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
+    for (unsigned int j(0); j < m_height; ++j)
     {
-        *p_temp++ -= aValue;
+        float* p_temp(getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            *p_temp++ -= aValue;
+        }
     }
+    m_halo_size = 0;
     
     // Return the result
     return (*this);
@@ -427,11 +744,15 @@ Image& Image::operator-=(float aValue)
 Image& Image::operator*=(float aValue)
 //------------------------------------
 {
-    float* p_temp(m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
+    for (unsigned int j(0); j < m_height; ++j)
     {
-        *p_temp++ *= aValue;
+        float* p_temp(getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            *p_temp++ *= aValue;
+        }
     }
+    m_halo_size = 0;
     
     // Return the result
     return (*this);
@@ -448,11 +769,15 @@ Image& Image::operator/=(float aValue)
         throw "Division by zero.";
     }
     
-    float* p_temp(m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
+    for (unsigned int j(0); j < m_height; ++j)
     {
-        *p_temp++ /= aValue;
+        float* p_temp(getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            *p_temp++ /= aValue;
+        }
     }
+    m_halo_size = 0;
     
     // Return the result
     return (*this);
@@ -463,76 +788,113 @@ Image& Image::operator/=(float aValue)
 Image Image::operator!()
 //----------------------
 {
-    // Copy the instance into a temporary variable
- 
-	Image temp(*this);
+    // Compute the result into a temporary variable
+    Image temp;
+    invert(temp);
+
+    // Return the result
+    return (temp);
+}
+
+
+//------------------------------------------
+void ImageView::invert(Image& anOutput) const
+//------------------------------------------
+{
+    // Pixels of the view would be overwritten before being read
+    if (isAliasing(*this, anOutput))
+    {
+        Image temp;
+        temp.setStorage(anOutput.m_aligned_flag, anOutput.m_halo_capacity);
+        invert(temp);
+        anOutput.swap(temp);
+        return;
+    }
+
     float min_value(getMinValue());
     float max_value(getMaxValue());
     float range(max_value - min_value);
-    
-    float* p_temp(temp.m_p_image);
-    
+
+    // Reuse the buffer of the output if possible
+    anOutput.setSize(m_width, m_height);
+
     // Process every pixel
-    for (unsigned int i(0); i < m_width * m_height; ++i, ++p_temp)
+    for (unsigned int j(0); j < m_height; ++j)
     {
-        // Take care to preserve the dynamic of the image
-        *p_temp = min_value + range * (1.0 - (*p_temp - min_value) / range);
+        const float* p_input(getRow(j));
+        float* p_output(anOutput.getRow(j));
+        for (unsigned int i(0); i < m_width; ++i, ++p_input, ++p_output)
+        {
+            // Take care to preserve the dynamic of the image
+            *p_output = min_value + range * (1.0 - (*p_input - min_value) / range);
+        }
     }
-    
-    // Return the result
-    return (temp);
 }
 
 
-//---------------------------------
-float Image::getAspectRatio() const
-//---------------------------------
+//-------------------------------------
+float ImageView::getAspectRatio() const
+//-------------------------------------
 {
     return (float(m_width) / float(m_height));
 }
 
 
-//----------------------------------
-unsigned int Image::getWidth() const
-//----------------------------------
+//--------------------------------------
+unsigned int ImageView::getWidth() const
+//--------------------------------------
 {
     return (m_width);
 }
 
 
-//-----------------------------------
-unsigned int Image::getHeight() const
-//-----------------------------------
+//---------------------------------------
+unsigned int ImageView::getHeight() const
+//---------------------------------------
 {
     return (m_height);
 }
 
 
-//------------------------------
-float Image::getMinValue() const
-//------------------------------
+//----------------------------------
+float ImageView::getMinValue() const
+//----------------------------------
 {
     // The image is empty
-    if (!m_p_image)
+    if (!m_p_image || !m_width || !m_height)
     {
         throw "Empty image";
     }
     
-    return (*std::min_element(&m_p_image[0], &m_p_image[m_width * m_height]));
+    float min_value(*m_p_image);
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        const float* p_row(getRow(j));
+        min_value = std::min(min_value, *std::min_element(p_row, p_row + m_width));
+    }
+
+    return (min_value);
 }
 
 
-//------------------------------
-float Image::getMaxValue() const
-//------------------------------
+//----------------------------------
+float ImageView::getMaxValue() const
+//----------------------------------
 {
     // The image is empty
-    if (!m_p_image)
+    if (!m_p_image || !m_width || !m_height)
     {
         throw "Empty image";
     }
     
-    return (*std::max_element(&m_p_image[0], &m_p_image[m_width * m_height]));
+    float max_value(*m_p_image);
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        const float* p_row(getRow(j));
+        max_value = std::max(max_value, *std::max_element(p_row, p_row + m_width));
+    }
+
+    return (max_value);
 }
 
 
@@ -541,11 +903,16 @@ void Image::shiftScaleFilter(float aShiftValue, float aScaleValue)
 //----------------------------------------------------------------
 {
     // Process every pixel of the image
-    for (unsigned int i = 0; i < m_width * m_height; ++i)
+    for (unsigned int j = 0; j < m_height; ++j)
     {
-        // Apply the shilft/scale filter
-        m_p_image[i] = (m_p_image[i] + aShiftValue) * aScaleValue;
+        float* p_row(getRow(j));
+        for (unsigned int i = 0; i < m_width; ++i)
+        {
+            // Apply the shilft/scale filter
+            p_row[i] = (p_row[i] + aShiftValue) * aScaleValue;
+        }
     }
+    m_halo_size = 0;
 }
 
 
@@ -553,7 +920,9 @@ void Image::shiftScaleFilter(float aShiftValue, float aScaleValue)
 void Image::normalize()
 //---------------------
 {
-    shiftScaleFilter(-getMinValue(), 1.0 / (getMaxValue() - getMinValue()));
+    // A single pass for the minimum and the maximum
+    const Statistics statistics(computeStats());
+    shiftScaleFilter(-statistics.m_min_value, 1.0 / (statistics.m_max_value - statistics.m_min_value));
 }
 
 
@@ -561,172 +930,85 @@ void Image::normalize()
 void Image::loadPGM(const char* aFileName)
 //----------------------------------------
 {
-    // Open the file
-    std::ifstream input_file(aFileName, std::ifstream::binary);
-    
+    // Map the file: the header and the pixels are read in place
+    MappedFile input_file;
+
     // The file does not exist
-    if (!input_file.is_open())
+    if (!input_file.open(aFileName))
     {
         // Build the error message
         std::stringstream error_message;
         error_message << "Cannot open the file \"" << aFileName << "\". It does not exist";
-    
+
         // Throw an error
         throw (error_message.str());
     }
-    // The file is open
-    else
+
+    // Invalid format, or truncated binary file
+    MappedFile::PGMHeader header;
+    if (!input_file.readPGMHeader(header))
     {
-        // Release the memory if necessary
-        destroy();
-    
-        // Variable to store a line
-        char p_line_data[LINE_SIZE];
-    
-        // Get the first line
-        input_file.getline(p_line_data, LINE_SIZE);
+        // Build the error message
+        std::stringstream error_message;
+        error_message << "Invalid file (\"" << aFileName << "\")";
 
-        // Get the image type
-        std::string image_type(p_line_data);
-    
-        // Valid ASCII format
-        if (image_type == "P2")
+        // Throw an error
+        throw (error_message.str());
+    }
+
+    // Allocate the memory
+    destroy();
+    setSize(header.m_width, header.m_height);
+
+    const std::size_t pixel_count(std::size_t(m_width) * m_height);
+    const unsigned char* p_data(header.m_p_pixels);
+
+    // Valid ASCII format
+    if (!header.m_is_binary)
+    {
+        // Read the pixel values
+        for (std::size_t i(0); i < pixel_count; ++i)
         {
-            // Variable to save the max value
-            int max_value(-1);
-        
-            // There is data to read
-            unsigned int pixel_count(0);
-            while (input_file.good())
+            unsigned int pixel_value(0);
+            p_data = input_file.readPGMValue(p_data, pixel_value);
+
+            // The file is truncated
+            if (!p_data)
             {
-                // Get the new line
-                input_file.getline(p_line_data, LINE_SIZE);
-    
-                // It is not a comment
-                if (p_line_data[0] != '#')
-                {
-                    // Store the line in a stream
-                    std::stringstream stream_line;
-                    stream_line << std::string(p_line_data);
-                
-                    // The memory is not allocated
-                    if (!m_p_image && !m_width && !m_height)
-                    {
-                        // Load the image size
-                        stream_line >> m_width >> m_height;
-                    
-                        // Alocate the memory
-                        m_p_image = new float[m_width * m_height];
-                    
-                        // Out of memory
-                        if (!m_p_image)
-                        {
-                            throw ("Out of memory");
-                        }
-                    }
-                    // The max value is not set
-                    else if (max_value < 0)
-                    {
-                        // Get the max value;
-                        stream_line >> max_value;
-                    }
-                    // Read the pixel data
-                    else
-                    {
-                        // Process all the pixels of the line
-                        while (stream_line.good())
-                        {
-                            // Get the pixel value
-                            int pixel_value(-1);
-                            stream_line >> pixel_value;
-                            // The pixel exists
-                            if (pixel_count < m_width * m_height)
-                            {
-                                m_p_image[pixel_count++] = pixel_value;
-                            }
-                        }
-                    }
-                }
+                // Build the error message
+                std::stringstream error_message;
+                error_message << "Invalid file (\"" << aFileName << "\")";
+
+                // Throw an error
+                throw (error_message.str());
             }
+
+            getRow(i / m_width)[i % m_width] = pixel_value;
         }
-        // Valid binary format
-        else if (image_type == "P5")
+    }
+    // Valid binary format: the rows are converted from the mapping
+    else
+    {
+        const unsigned int bytes_per_pixel(header.m_bytes_per_pixel);
+        for (unsigned int j(0); j < m_height; ++j)
         {
-            // Variable to save the max value
-            int max_value(-1);
+            float* p_row(getRow(j));
+            const unsigned char* p_input(p_data + std::size_t(j) * m_width * bytes_per_pixel);
 
-            // There is data to read
-            unsigned int pixel_count(0);
-            while (input_file.good() && !pixel_count)
+            // One byte per pixel
+            if (bytes_per_pixel == 1)
             {
-            	// Process as an ASCII file
-                if (!m_width || !m_height || max_value < 0)
-                {
-                    // Get the new line
-                    input_file.getline(p_line_data, LINE_SIZE);
-
-                    // It is not a comment
-                    if (p_line_data[0] != '#')
-                    {
-                        // Store the line in a stream
-                        std::stringstream stream_line;
-                        stream_line << std::string(p_line_data);
-
-                        // The memory is not allocated
-                        if (!m_p_image && !m_width && !m_height)
-                        {
-                            // Load the image size
-                            stream_line >> m_width >> m_height;
-
-                            // Alocate the memory
-                            m_p_image = new float[m_width * m_height];
-
-                            // Out of memory
-                            if (!m_p_image)
-                            {
-                                throw ("Out of memory");
-                            }
-                        }
-                        // The max value is not set
-                        else
-                        {
-                            // Get the max value;
-                            stream_line >> max_value;
-                        }
-                    }
-                }
-                // Read the pixel data
-                else
+                RowKernels::convert(p_input, p_row, m_width);
+            }
+            // Two bytes per pixel, the most significant first
+            else
+            {
+                for (unsigned int i(0); i < m_width; ++i)
                 {
-                	unsigned char* p_temp(new unsigned char[m_width * m_height]);
-
-                    // Out of memory
-                    if (!p_temp)
-                    {
-                        throw ("Out of memory");
-                    }
-
-                    input_file.read(reinterpret_cast<char*>(p_temp), m_width * m_height);
-
-                	for (unsigned int i(0); i < m_width * m_height; ++i)
-                	{
-                		m_p_image[i] = p_temp[i];
-                        ++pixel_count;
-                	}
-                	delete [] p_temp;
+                    p_row[i] = (p_input[2 * i] << 8) | p_input[2 * i + 1];
                 }
             }
         }
-        // Invalid format
-        else
-        {
-            // Build the error message
-            std::stringstream error_message;
-            error_message << "Invalid file (\"" << aFileName << "\")";
-
-            // Throw an error
-            throw (error_message.str());
-        }
     }
 }
 
@@ -739,10 +1021,22 @@ void Image::loadPGM(const std::string& aFileName)
 }
 
 
-//----------------------------------------
-void Image::savePGM(const char* aFileName)
-//----------------------------------------
+//-------------------------------------------------------------
+void Image::savePGM(const char* aFileName, PGMFormat aFormat)
+//-------------------------------------------------------------
 {
+    // Convert the pixels in a vectorised pass, then write them at once
+    if (aFormat == PGM_BINARY_8)
+    {
+        Image8(*this).savePGM(aFileName);
+        return;
+    }
+    else if (aFormat == PGM_BINARY_16)
+    {
+        Image16(*this).savePGM(aFileName);
+        return;
+    }
+
     // Open the file
     std::ofstream output_file(aFileName);
     
@@ -779,7 +1073,7 @@ void Image::savePGM(const char* aFileName)
             for (unsigned int i = 0; i < m_width; ++i)
             {
                 // Process the pixel
-                int pixel_value(m_p_image[j * m_width + i]);
+                int pixel_value(m_p_image[j * m_stride + i]);
                 pixel_value = std::max(0, pixel_value);
                 pixel_value = std::min(255, pixel_value);
             
@@ -792,21 +1086,21 @@ void Image::savePGM(const char* aFileName)
                 }
             }
         
-            // It is not the last line of the image
+            // It is not the last line of the image (no flush)
             if (j < (m_height - 1))
             {
-                output_file << std::endl;
+                output_file << '\n';
             }
         }
     }
 }
 
 
-//-----------------------------------------------
-void Image::savePGM(const std::string& aFileName)
-//-----------------------------------------------
+//--------------------------------------------------------------------
+void Image::savePGM(const std::string& aFileName, PGMFormat aFormat)
+//--------------------------------------------------------------------
 {
-    savePGM(aFileName.data());
+    savePGM(aFileName.data(), aFormat);
 }
 
 
@@ -816,11 +1110,11 @@ void Image::loadRaw(const char* aFileName,
                     unsigned int aHeight)
 //----------------------------------------
 {
-    // Open the file in binary
-    std::ifstream input_file (aFileName, std::ifstream::binary);
+    // Map the file
+    MappedFile input_file;
 
     // The file is not open
-    if (!input_file.is_open())
+    if (!input_file.open(aFileName))
     {
         std::string error_message("The file (");
         error_message += aFileName;
@@ -829,12 +1123,8 @@ void Image::loadRaw(const char* aFileName,
         throw error_message;
     }
 
-    // Get size of file
-    input_file.seekg(0, input_file.end);
-    unsigned int size(input_file.tellg());
-
     // The size is not correct
-    if (aWidth * aHeight * sizeof(float) != size)
+    if (std::size_t(aWidth) * aHeight * sizeof(float) != input_file.getSize())
     {
         std::stringstream error_message;
         error_message << "The size of " << aFileName << " is not " <<
@@ -843,19 +1133,18 @@ void Image::loadRaw(const char* aFileName,
         throw error_message.str();
     }
 
-    // Rewind the file
-    input_file.seekg (0);
-
     // Release the memory
     destroy();
 
     // Allocate memory for file content
-    m_width = aWidth;
-    m_height = aHeight;
-    m_p_image = new float[m_width * m_height];
+    setSize(aWidth, aHeight);
 
-    // Read content of input_file
-    input_file.read(reinterpret_cast<char*>(m_p_image), size);
+    // Copy the rows from the mapping
+    const float* p_input(reinterpret_cast<const float*>(input_file.getData()));
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        std::copy(p_input + std::size_t(j) * m_width, p_input + std::size_t(j + 1) * m_width, getRow(j));
+    }
 }
 
 
@@ -887,7 +1176,10 @@ void Image::saveRaw(const char* aFileName)
     }
 
     // Write content to file
-    output_file.write(reinterpret_cast<char*>(m_p_image), m_width * m_height * sizeof(float));
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        output_file.write(reinterpret_cast<const char*>(getRow(j)), m_width * sizeof(float));
+    }
 }
 
 
@@ -951,12 +1243,13 @@ void Image::loadASCII(const char* aFileName)
     destroy();
 
     // Allocate memory for file content
-    m_width = number_of_columns;
-    m_height = number_of_rows;
-    m_p_image = new float[m_width * m_height];
+    setSize(number_of_columns, number_of_rows);
 
     // Copy the data
-    std::copy(p_data.begin(), p_data.end(), m_p_image);
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        std::copy(p_data.begin() + j * m_width, p_data.begin() + (j + 1) * m_width, getRow(j));
+    }
 }
 
 
@@ -986,9 +1279,9 @@ void Image::saveASCII(const char* aFileName)
     }
 
     // Write content to file
-    float* p_data(m_p_image);
     for (unsigned int j(0); j < m_height; ++j)
     {
+        const float* p_data(getRow(j));
         for (unsigned int i(0); i < m_width; ++i)
         {
             output_file << *p_data++;
@@ -1011,527 +1304,2061 @@ void Image::saveASCII(const char* aFileName)
 }
 
 
-//-------------------------------------------------
-void Image::saveASCII(const std::string& aFileName)
-//-------------------------------------------------
+//-------------------------------------------------
+void Image::saveASCII(const std::string& aFileName)
+//-------------------------------------------------
+{
+    saveASCII(aFileName.data());
+}
+
+
+//----------------------------------------------------
+bool ImageView::operator==(const ImageView& anImage) const
+//--------------------------------------------------------
+{
+    if (m_width != anImage.m_width)
+    {
+        return (false);
+    }
+
+    if (m_height != anImage.m_height)
+    {
+        return (false);
+    }
+
+    for (unsigned int j(0); j < m_height; ++j)
+    {
+        float const * p_data1(getRow(j));
+        float const * p_data2(anImage.getRow(j));
+        for (unsigned int i(0); i < m_width; ++i)
+        {
+            if (std::abs(*p_data1++ - *p_data2++) > 1.0e-6)
+            {
+                return (false);
+            }
+        }
+    }
+
+    return (true);
+}
+
+//----------------------------------------------------------------
+ImageView::Comparison ImageView::compare(const ImageView& anImage, float aPeakValue) const
+//----------------------------------------------------------------
+{
+	if (getWidth() != anImage.getWidth() || getHeight() != anImage.getHeight())
+	{
+		throw "The images have different sizes";
+	}
+
+	// The sums of every row, in double precision, on the pixels minus the
+	// first pixel of each image
+	const float first_shift(m_width && m_height ? *m_p_image : 0);
+	const float second_shift(m_width && m_height ? *anImage.m_p_image : 0);
+	std::vector<RowKernels::RowComparison> row_comparison_set(m_height);
+
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				RowKernels::compare(getRow(j), anImage.getRow(j), m_width,
+					first_shift, second_shift, row_comparison_set[j]);
+			}
+		});
+
+	// Add the rows in order
+	RowKernels::RowComparison sum = { 0, 0, 0, 0, 0, 0, 0 };
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		const RowKernels::RowComparison& row(row_comparison_set[j]);
+		sum.m_absolute_sum += row.m_absolute_sum;
+		sum.m_square_sum += row.m_square_sum;
+		sum.m_first_sum += row.m_first_sum;
+		sum.m_second_sum += row.m_second_sum;
+		sum.m_first_square_sum += row.m_first_square_sum;
+		sum.m_second_square_sum += row.m_second_square_sum;
+		sum.m_product_sum += row.m_product_sum;
+	}
+
+	const double count(double(m_width) * m_height);
+
+	Comparison comparison;
+	comparison.m_sae = sum.m_absolute_sum;
+	comparison.m_ssd = sum.m_square_sum;
+	comparison.m_mse = count ? sum.m_square_sum / count : 0;
+	comparison.m_psnr = comparison.m_mse > 0 ?
+		10.0 * std::log10(double(aPeakValue) * aPeakValue / comparison.m_mse) :
+		std::numeric_limits<double>::infinity();
+	comparison.m_ncc = 0;
+
+	// Covariance / (standard deviation of a * standard deviation of b)
+	if (count)
+	{
+		const double first_mean(sum.m_first_sum / count);
+		const double second_mean(sum.m_second_sum / count);
+		const double covariance(sum.m_product_sum / count - first_mean * second_mean);
+		const double first_variance(sum.m_first_square_sum / count - first_mean * first_mean);
+		const double second_variance(sum.m_second_square_sum / count - second_mean * second_mean);
+
+		if (first_variance > 0 && second_variance > 0)
+		{
+			comparison.m_ncc = std::max(-1.0, std::min(1.0, covariance / std::sqrt(first_variance * second_variance)));
+		}
+	}
+
+	return (comparison);
+}
+
+//----------------------------------------------------------------
+float ImageView::getSAE(const ImageView& anImage) const
+//----------------------------------------------------------------
+{
+	if (getWidth() != anImage.getWidth() || getHeight() != anImage.getHeight())
+	{
+		return (false);
+	}
+
+	return (compare(anImage).m_sae);
+}
+
+//----------------------------------------------------------------
+float ImageView::getNCC(const ImageView& anImage) const
+//----------------------------------------------------------------
+{
+	if (getWidth() != anImage.getWidth() || getHeight() != anImage.getHeight())
+	{
+		return (false);
+	}
+
+	return (compare(anImage).m_ncc);
+}
+
+
+//----------------------------------------------------------------
+ImageView::Statistics ImageView::computeStats() const
+//----------------------------------------------------------------
+{
+	// The image is empty
+	if (!m_p_image || !m_width || !m_height)
+	{
+		throw "Empty image";
+	}
+
+	// The sums are computed on the pixels minus a pixel of the image
+	const float shift(*m_p_image);
+
+	float min_value(shift);
+	float max_value(shift);
+	double sum(0);
+	double square_sum(0);
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		RowKernels::RowStatistics row_statistics;
+		RowKernels::getStatistics(getRow(j), m_width, shift, row_statistics);
+
+		min_value = std::min(min_value, row_statistics.m_min_value);
+		max_value = std::max(max_value, row_statistics.m_max_value);
+		sum += row_statistics.m_sum;
+		square_sum += row_statistics.m_square_sum;
+	}
+
+	// E[(x - shift)^2] - E[x - shift]^2
+	const double count(double(m_width) * m_height);
+	const double mean(sum / count);
+	const double variance(std::max(0.0, square_sum / count - mean * mean));
+
+	Statistics statistics;
+	statistics.m_min_value = min_value;
+	statistics.m_max_value = max_value;
+	statistics.m_mean = float(shift + mean);
+	statistics.m_variance = float(variance);
+	statistics.m_standard_deviation = float(std::sqrt(variance));
+
+	return (statistics);
+}
+
+
+//----------------------------------------------------------------
+float ImageView::getAverage() const
+//----------------------------------------------------------------
+{
+	return (computeStats().m_mean);
+}
+
+
+//----------------------------------------------------------------
+float ImageView::getVariance() const
+//----------------------------------------------------------------
+{
+	return (computeStats().m_variance);
+}
+
+//----------------------------------------------------------------
+float ImageView::getStandardDeviation() const
+//----------------------------------------------------------------
+{
+	return (computeStats().m_standard_deviation);
+}
+
+//----------------------------------------------------------------
+Image ImageView::blendImage(const ImageView& anImage, float blendRatio) const
+//----------------------------------------------------------------
+{
+	Image tempImage;
+	blendImage(anImage, blendRatio, tempImage);
+	return tempImage;
+}
+
+//----------------------------------------------------------------
+void ImageView::blendImage(const ImageView& anImage, float blendRatio, Image& anOutput) const
+//----------------------------------------------------------------
+{
+	if (getWidth() != anImage.getWidth() || getHeight() != anImage.getHeight())
+	{
+		std::cout << "Images not of the same size" << std::endl;
+	}
+
+	//pixels of a view would be overwritten before being read
+	if (isAliasing(*this, anOutput) || isAliasing(anImage, anOutput))
+	{
+		Image temp;
+		temp.setStorage(anOutput.m_aligned_flag, anOutput.m_halo_capacity);
+		blendImage(anImage, blendRatio, temp);
+		anOutput.swap(temp);
+		return;
+	}
+
+	//reuse the buffer of the output if possible
+	anOutput.setSize(m_width, m_height);
+
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		const float* p_row1(getRow(j));
+		const float* p_row2(anImage.getRow(j));
+		float* p_temp(anOutput.getRow(j));
+		for (unsigned int i(0); i < m_width; ++i)
+		{
+			p_temp[i]= (p_row1[i] + (1-blendRatio) * p_row2[i]);
+		}
+	}
+}
+
+//----------------------------------------------------------------
+float ImageView::createHistogram(const int aNumberOfBins) const
+//----------------------------------------------------------------
+{
+	std::cout << "bins" << aNumberOfBins << std::endl;
+
+	// Every pixel is counted in a single pass
+	const std::vector<unsigned int> bins(getHistogram(aNumberOfBins));
+
+	for (int i(0); i < aNumberOfBins; ++i) {
+		std::cout << i << ": "<< bins[i] << " ," << std::endl;
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------
+std::vector<unsigned int> ImageView::getHistogram(unsigned int aNumberOfBins) const
+//----------------------------------------------------------------
+{
+	// A single pass for the range
+	float min_value(0), max_value(0);
+	computeRange(min_value, max_value);
+
+	return (getHistogram(aNumberOfBins, min_value, max_value));
+}
+
+//----------------------------------------------------------------
+std::vector<unsigned int> ImageView::getHistogram(unsigned int aNumberOfBins,
+		float aMinValue,
+		float aMaxValue) const
+//----------------------------------------------------------------
+{
+	if (!aNumberOfBins)
+	{
+		throw "Invalid number of bins";
+	}
+
+	std::vector<unsigned int> histogram_data(aNumberOfBins, 0);
+	std::mutex histogram_mutex;
+
+	// Every thread counts the pixels of its band in private bins, then adds
+	// them to the histogram
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			std::vector<unsigned int> band_histogram(aNumberOfBins, 0);
+			accumulateHistogram(aFirstRow, aLastRow, aNumberOfBins, aMinValue, aMaxValue, &band_histogram[0]);
+
+			std::lock_guard<std::mutex> lock(histogram_mutex);
+			for (unsigned int i(0); i < aNumberOfBins; ++i)
+			{
+				histogram_data[i] += band_histogram[i];
+			}
+		});
+
+	return (histogram_data);
+}
+
+//----------------------------------------------------------------
+std::vector<unsigned int> ImageView::get8BitHistogram() const
+//----------------------------------------------------------------
+{
+	std::vector<unsigned int> histogram_data(256, 0);
+	std::mutex histogram_mutex;
+
+	// Private bins for every thread, as getHistogram
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			unsigned int p_band_histogram[256] = {};
+			accumulate8BitHistogram(aFirstRow, aLastRow, p_band_histogram);
+
+			std::lock_guard<std::mutex> lock(histogram_mutex);
+			for (unsigned int i(0); i < 256; ++i)
+			{
+				histogram_data[i] += p_band_histogram[i];
+			}
+		});
+
+	return (histogram_data);
+}
+
+//----------------------------------------------------------------
+void ImageView::writeHistogram(unsigned int aNumberOfBins, const std::string& aFileName) const
+//----------------------------------------------------------------
+{
+	writeHistogram(aNumberOfBins, aFileName.data());
+}
+//----------------------------------------------------------------
+void ImageView::writeHistogram(unsigned int aNumberOfBins, const char * aFileName) const
+//----------------------------------------------------------------
+{
+	std::ofstream output_stream(aFileName); // Open the file
+	if (!output_stream.is_open()) // The file is not open
+	{
+		std::string error_message("Cannot open file (output.dat).");
+		throw (error_message); // Throw an error
+	}
+
+	float min_value(0), max_value(0);
+	computeRange(min_value, max_value);
+	float range = max_value - min_value;
+	float bins = range / aNumberOfBins;
+	float minBinValue = min_value;
+	const std::vector<unsigned int> histogram(getHistogram(aNumberOfBins, min_value, max_value));
+	output_stream << "\"Min bin value\"" << " " << "\"Count\"" << std::endl;
+	for (int i = 0; i< aNumberOfBins; i++)
+	{
+
+		output_stream << minBinValue << " " << histogram[i] << std::endl;
+		minBinValue += bins;
+	}
+
+	output_stream.close();
+}
+
+
+
+//----------------------------------------------------------------
+Image ImageView::segmentImage(const float threshold) const
+//----------------------------------------------------------------
+{
+	Image tempImage;
+	segmentImage(threshold, tempImage);
+	return tempImage;
+}
+
+//----------------------------------------------------------------
+void ImageView::segmentImage(const float threshold, Image& anOutput) const
+//----------------------------------------------------------------
+{
+	const float BLACK = 0;
+	const float WHITE = 255;
+
+	//pixels of the view would be overwritten before being read
+	if (isAliasing(*this, anOutput))
+	{
+		Image temp;
+		temp.setStorage(anOutput.m_aligned_flag, anOutput.m_halo_capacity);
+		segmentImage(threshold, temp);
+		anOutput.swap(temp);
+		return;
+	}
+
+	//reuse the buffer of the output if possible
+	anOutput.setSize(m_width, m_height);
+	
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		const float* p_row(getRow(j));
+		float* p_temp(anOutput.getRow(j));
+		for (unsigned int i(0); i < m_width; ++i)
+		{
+			if (p_row[i] < threshold)
+			{
+				p_temp[i] = BLACK;
+			} 
+			
+			else if (p_row[i] > threshold)
+			{
+				p_temp[i] = WHITE;
+			}
+			else
+			{
+				p_temp[i] = p_row[i];
+			}
+		}
+	}
+}
+//----------------------------------------------------------------
+int ImageView::getBorderIndex(int anIndex, int aSize, BorderMode aBorderMode)
+//----------------------------------------------------------------
+{
+	// Mirror about the edge pixel (the edge pixel is not repeated)
+	if (aBorderMode == BORDER_REFLECT && aSize > 1)
+	{
+		const int period(2 * aSize - 2);
+
+		anIndex %= period;
+		if (anIndex < 0)
+		{
+			anIndex += period;
+		}
+
+		if (anIndex >= aSize)
+		{
+			anIndex = period - anIndex;
+		}
+
+		return (anIndex);
+	}
+
+	// Repeat the closest edge pixel
+	return (std::min(std::max(anIndex, 0), aSize - 1));
+}
+
+
+//----------------------------------------------------------------
+void ImageView::extendRow(const float* apRow,
+	unsigned int aWidth,
+	unsigned int aRadius,
+	BorderMode aBorderMode,
+	float aBorderValue,
+	float* apOutput)
+//----------------------------------------------------------------
+{
+	// The row itself
+	std::copy(apRow, apRow + aWidth, apOutput + aRadius);
+
+	// The pixels on the left and on the right
+	for (unsigned int i(0); i < aRadius; ++i)
+	{
+		const int left_index(int(i) - int(aRadius));
+		const int right_index(aWidth + i);
+
+		if (aBorderMode == BORDER_CONSTANT)
+		{
+			apOutput[i] = aBorderValue;
+			apOutput[aRadius + aWidth + i] = aBorderValue;
+		}
+		else
+		{
+			apOutput[i] = apRow[getBorderIndex(left_index, aWidth, aBorderMode)];
+			apOutput[aRadius + aWidth + i] = apRow[getBorderIndex(right_index, aWidth, aBorderMode)];
+		}
+	}
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::convolve(const std::vector<float>& aKernel,
+	unsigned int aKernelWidth,
+	unsigned int aKernelHeight,
+	BorderMode aBorderMode,
+	float aBorderValue,
+	ConvolutionMethod aMethod) const
+//----------------------------------------------------------------
+{
+	// Invalid kernel
+	if (aKernel.size() != aKernelWidth * aKernelHeight)
+	{
+		throw "The size of the kernel does not match its width and height";
+	}
+
+	if (!(aKernelWidth % 2) || !(aKernelHeight % 2))
+	{
+		throw "The size of a kernel must be odd";
+	}
+
+	// Rank-1 kernel: two 1D passes (unless another method is requested)
+	std::vector<float> horizontal_kernel, vertical_kernel;
+	if ((aMethod == CONVOLUTION_AUTO || aMethod == CONVOLUTION_SEPARABLE) &&
+		getSeparableKernels(aKernel, aKernelWidth, aKernelHeight, horizontal_kernel, vertical_kernel))
+	{
+		return (convolveSeparable(horizontal_kernel, vertical_kernel, aBorderMode, aBorderValue));
+	}
+
+	// The kernel cannot be separated
+	if (aMethod == CONVOLUTION_SEPARABLE)
+	{
+		throw "The kernel is not separable";
+	}
+
+	// Large kernels: FFTs, if it is cheaper than one multiply-add per weight
+	if (aMethod == CONVOLUTION_AUTO)
+	{
+		unsigned int weight_count(0);
+		for (unsigned int k(0); k < aKernel.size(); ++k)
+		{
+			if (aKernel[k])
+			{
+				++weight_count;
+			}
+		}
+
+		double fft_cost(0);
+		getFFTTileSize(aKernelWidth, aKernelHeight, fft_cost);
+		if (fft_cost < double(weight_count) * m_width * m_height)
+		{
+			aMethod = CONVOLUTION_FFT;
+		}
+	}
+
+	if (aMethod == CONVOLUTION_FFT)
+	{
+		return (convolveFFT(aKernel, aKernelWidth, aKernelHeight, aBorderMode, aBorderValue));
+	}
+
+	return (convolveDirect(aKernel, aKernelWidth, aKernelHeight, aBorderMode, aBorderValue));
+}
+
+
+//----------------------------------------------------------------
+unsigned int ImageView::getFFTTileSize(unsigned int aKernelWidth,
+	unsigned int aKernelHeight,
+	double& aCost) const
+//----------------------------------------------------------------
+{
+	// Size of the image extended by the border
+	const unsigned int padded_width(m_width + aKernelWidth - 1);
+	const unsigned int padded_height(m_height + aKernelHeight - 1);
+
+	// Relative cost of a complex operation of the FFT vs a SIMD multiply-add
+	// (measured: the FFT wins from about 35x35 weights on a 512x512 image)
+	const double FFT_OPERATION_COST(20.0);
+
+	unsigned int best_size(0);
+	aCost = 0;
+
+	// The tiles must be larger than the kernel, and not much larger than the image
+	const unsigned int largest_size(FFT::getPowerOfTwo(std::max(padded_width, padded_height) + std::max(aKernelWidth, aKernelHeight)));
+	for (unsigned int size(FFT::getPowerOfTwo(std::max(aKernelWidth, aKernelHeight) + 1)); size <= largest_size; size *= 2)
+	{
+		// Every tile covers (size - kernel + 1) pixels along each axis
+		const unsigned int block_width(size - aKernelWidth + 1);
+		const unsigned int block_height(size - aKernelHeight + 1);
+		const double tile_count(double((padded_width + block_width - 1) / block_width) *
+			((padded_height + block_height - 1) / block_height));
+
+		// Two 2D transforms of size^2 log2(size^2) butterflies, and the product
+		double log_size(0);
+		for (unsigned int i(size); i > 1; i /= 2)
+		{
+			++log_size;
+		}
+		const double cost(FFT_OPERATION_COST * tile_count * double(size) * size * (4 * log_size + 1));
+
+		if (!best_size || cost < aCost)
+		{
+			best_size = size;
+			aCost = cost;
+		}
+	}
+
+	return (best_size);
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::convolveFFT(const std::vector<float>& aKernel,
+	unsigned int aKernelWidth,
+	unsigned int aKernelHeight,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	const unsigned int horizontal_radius(aKernelWidth / 2);
+	const unsigned int vertical_radius(aKernelHeight / 2);
+
+	// Black image (the tiles are accumulated)
+	Image temp(m_width, m_height);
+
+	// Empty image
+	if (!m_width || !m_height)
+	{
+		return (temp);
+	}
+
+	// The image extended by the border
+	const unsigned int padded_width(m_width + 2 * horizontal_radius);
+	const unsigned int padded_height(m_height + 2 * vertical_radius);
+	std::vector<float> padded_image(padded_width * padded_height, aBorderValue);
+
+	for (unsigned int j(0); j < padded_height; ++j)
+	{
+		const int y(int(j) - int(vertical_radius));
+		if (aBorderMode != BORDER_CONSTANT || (y >= 0 && y < int(m_height)))
+		{
+			extendRow(getRow(getBorderIndex(y, m_height, aBorderMode)),
+				m_width, horizontal_radius, aBorderMode, aBorderValue,
+				&padded_image[j * padded_width]);
+		}
+	}
+
+	// Tile size, and size of the block of the padded image covered by a tile
+	double cost(0);
+	const unsigned int tile_size(getFFTTileSize(aKernelWidth, aKernelHeight, cost));
+	const unsigned int block_width(tile_size - aKernelWidth + 1);
+	const unsigned int block_height(tile_size - aKernelHeight + 1);
+	const FFT fft(tile_size);
+
+	// Spectrum of the flipped kernel (correlation as a convolution)
+	std::vector<FFT::Complex> kernel_spectrum(tile_size * tile_size);
+	for (unsigned int j(0); j < aKernelHeight; ++j)
+	{
+		for (unsigned int i(0); i < aKernelWidth; ++i)
+		{
+			kernel_spectrum[j * tile_size + i] =
+				aKernel[(aKernelHeight - 1 - j) * aKernelWidth + (aKernelWidth - 1 - i)];
+		}
+	}
+	fft.forward2D(&kernel_spectrum[0]);
+
+	// Process the padded image one row of blocks at a time
+	const unsigned int block_count((padded_width + block_width - 1) / block_width);
+	std::vector<float> tile_set(block_count * tile_size * tile_size);
+
+	for (unsigned int block_y(0); block_y < padded_height; block_y += block_height)
+	{
+		// Filter every block of the row in parallel
+		getThreadPool().parallelFor(0, block_count,
+			[&](unsigned int aFirstBlock, unsigned int aLastBlock)
+			{
+				std::vector<FFT::Complex> tile(tile_size * tile_size);
+
+				for (unsigned int block(aFirstBlock); block < aLastBlock; ++block)
+				{
+					const unsigned int block_x(block * block_width);
+
+					// Copy the block, zero elsewhere
+					std::fill(tile.begin(), tile.end(), FFT::Complex(0));
+					for (unsigned int j(0); j < block_height && block_y + j < padded_height; ++j)
+					{
+						const float* p_input(&padded_image[(block_y + j) * padded_width]);
+						for (unsigned int i(0); i < block_width && block_x + i < padded_width; ++i)
+						{
+							tile[j * tile_size + i] = p_input[block_x + i];
+						}
+					}
+
+					// Product of the spectra
+					fft.forward2D(&tile[0]);
+					for (unsigned int k(0); k < tile.size(); ++k)
+					{
+						const FFT::Complex& a(tile[k]);
+						const FFT::Complex& b(kernel_spectrum[k]);
+						tile[k] = FFT::Complex(a.real() * b.real() - a.imag() * b.imag(),
+							a.real() * b.imag() + a.imag() * b.real());
+					}
+					fft.inverse2D(&tile[0]);
+
+					float* p_tile(&tile_set[block * tile_size * tile_size]);
+					for (unsigned int k(0); k < tile.size(); ++k)
+					{
+						p_tile[k] = tile[k].real();
+					}
+				}
+			});
+
+		// Add the overlapping tiles in a fixed order (the output is deterministic).
+		// The sample (y, x) of the full convolution is the output pixel
+		// (y - kernel height + 1, x - kernel width + 1).
+		for (unsigned int block(0); block < block_count; ++block)
+		{
+			const float* p_tile(&tile_set[block * tile_size * tile_size]);
+			const int block_x(block * block_width);
+
+			for (unsigned int j(0); j < tile_size; ++j)
+			{
+				const int y(int(block_y + j) - int(aKernelHeight - 1));
+				if (y < 0 || y >= int(m_height))
+				{
+					continue;
+				}
+
+				for (unsigned int i(0); i < tile_size; ++i)
+				{
+					const int x(block_x + int(i) - int(aKernelWidth - 1));
+					if (x >= 0 && x < int(m_width))
+					{
+						temp.getRow(y)[x] += p_tile[j * tile_size + i];
+					}
+				}
+			}
+		}
+	}
+
+	return (temp);
+}
+
+
+//----------------------------------------------------------------
+bool ImageView::getSeparableKernels(const std::vector<float>& aKernel,
+	unsigned int aKernelWidth,
+	unsigned int aKernelHeight,
+	std::vector<float>& aHorizontalKernel,
+	std::vector<float>& aVerticalKernel)
+//----------------------------------------------------------------
+{
+	// The weight with the largest magnitude
+	unsigned int pivot_index(0);
+	for (unsigned int k(1); k < aKernel.size(); ++k)
+	{
+		if (std::abs(aKernel[k]) > std::abs(aKernel[pivot_index]))
+		{
+			pivot_index = k;
+		}
+	}
+
+	const float pivot(aKernel[pivot_index]);
+	const unsigned int pivot_row(pivot_index / aKernelWidth);
+	const unsigned int pivot_column(pivot_index % aKernelWidth);
+
+	// The row of the pivot, and its column divided by the pivot
+	aHorizontalKernel.assign(aKernel.begin() + pivot_row * aKernelWidth,
+		aKernel.begin() + (pivot_row + 1) * aKernelWidth);
+
+	aVerticalKernel.resize(aKernelHeight);
+	for (unsigned int j(0); j < aKernelHeight; ++j)
+	{
+		aVerticalKernel[j] = pivot ? aKernel[j * aKernelWidth + pivot_column] / pivot : 0;
+	}
+
+	// Every weight must be the product of its row and column weights
+	const float tolerance(1.0e-6 * std::abs(pivot));
+	for (unsigned int j(0); j < aKernelHeight; ++j)
+	{
+		for (unsigned int i(0); i < aKernelWidth; ++i)
+		{
+			if (std::abs(aKernel[j * aKernelWidth + i] - aVerticalKernel[j] * aHorizontalKernel[i]) > tolerance)
+			{
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::convolveDirect(const std::vector<float>& aKernel,
+	unsigned int aKernelWidth,
+	unsigned int aKernelHeight,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	const unsigned int horizontal_radius(aKernelWidth / 2);
+	const unsigned int vertical_radius(aKernelHeight / 2);
+	const unsigned int extended_width(m_width + 2 * horizontal_radius);
+
+	// Black image (the weighted rows are accumulated)
+	Image temp(m_width, m_height);
+
+	// Empty image
+	if (!m_width || !m_height)
+	{
+		return (temp);
+	}
+
+	// The halo of the image holds the border: read the rows in place
+	const bool has_halo(hasHalo(std::max(horizontal_radius, vertical_radius), aBorderMode, aBorderValue));
+
+	// Otherwise every row extended by the border, and a row outside of the image
+	std::vector<float> extended_image(has_halo ? 0 : extended_width * m_height);
+	const std::vector<float> constant_row(extended_width, aBorderValue);
+
+	for (unsigned int j(0); !has_halo && j < m_height; ++j)
+	{
+		extendRow(getRow(j), m_width, horizontal_radius,
+			aBorderMode, aBorderValue, &extended_image[j * extended_width]);
+	}
+
+	// Add a weighted, shifted copy of the rows for every weight
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				float* p_output(temp.getRow(j));
+				for (unsigned int ky(0); ky < aKernelHeight; ++ky)
+				{
+					const int y(int(j + ky) - int(vertical_radius));
+					const float* p_input(&constant_row[0]);
+
+					if (has_halo)
+					{
+						p_input = m_p_image + y * int(m_stride) - int(horizontal_radius);
+					}
+					else if (aBorderMode != BORDER_CONSTANT || (y >= 0 && y < int(m_height)))
+					{
+						p_input = &extended_image[getBorderIndex(y, m_height, aBorderMode) * extended_width];
+					}
+
+					for (unsigned int kx(0); kx < aKernelWidth; ++kx)
+					{
+						const float weight(aKernel[ky * aKernelWidth + kx]);
+						if (weight)
+						{
+							RowKernels::multiplyAdd(p_input + kx, weight, p_output, m_width);
+						}
+					}
+				}
+			}
+		});
+
+	return (temp);
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::convolveSeparable(const std::vector<float>& aHorizontalKernel,
+	const std::vector<float>& aVerticalKernel,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	// The kernels must have a centre
+	if (!(aHorizontalKernel.size() % 2) || !(aVerticalKernel.size() % 2))
+	{
+		throw "The size of a kernel must be odd";
+	}
+
+	const unsigned int horizontal_radius(aHorizontalKernel.size() / 2);
+	const unsigned int vertical_radius(aVerticalKernel.size() / 2);
+
+	// Black images (the passes accumulate)
+	Image horizontal_pass(m_width, m_height);
+	Image temp(m_width, m_height);
+
+	// Empty image
+	if (!m_width || !m_height)
+	{
+		return (temp);
+	}
+
+	// The halo of the image holds the border of the rows: no copy
+	const bool has_halo(hasHalo(horizontal_radius, aBorderMode, aBorderValue));
+
+	// Horizontal pass: add weighted, shifted copies of every extended row
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			std::vector<float> extended_row(m_width + 2 * horizontal_radius);
+
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				const float* p_input(&extended_row[0]);
+				if (has_halo)
+				{
+					p_input = getRow(j) - horizontal_radius;
+				}
+				else
+				{
+					extendRow(getRow(j), m_width, horizontal_radius,
+						aBorderMode, aBorderValue, &extended_row[0]);
+				}
+
+				float* p_output(horizontal_pass.getRow(j));
+				for (unsigned int k(0); k < aHorizontalKernel.size(); ++k)
+				{
+					RowKernels::multiplyAdd(p_input + k, aHorizontalKernel[k], p_output, m_width);
+				}
+			}
+		});
+
+	// With a constant border, a row outside the image is constant after the first pass
+	float horizontal_sum(0);
+	for (unsigned int k(0); k < aHorizontalKernel.size(); ++k)
+	{
+		horizontal_sum += aHorizontalKernel[k];
+	}
+	const std::vector<float> constant_row(m_width, aBorderValue * horizontal_sum);
+
+	// Vertical pass: add weighted rows of the first pass (whole rows at a time)
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				float* p_output(temp.getRow(j));
+				for (unsigned int k(0); k < aVerticalKernel.size(); ++k)
+				{
+					const int y(int(j + k) - int(vertical_radius));
+					const float* p_input(&constant_row[0]);
+
+					if (aBorderMode != BORDER_CONSTANT || (y >= 0 && y < int(m_height)))
+					{
+						p_input = horizontal_pass.getRow(getBorderIndex(y, m_height, aBorderMode));
+					}
+
+					RowKernels::multiplyAdd(p_input, aVerticalKernel[k], p_output, m_width);
+				}
+			}
+		});
+
+	return (temp);
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::boxBlur(unsigned int aRadius,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	const unsigned int box_size(2 * aRadius + 1);
+
+	// Sums along the rows, then averages
+	Image horizontal_pass(m_width, m_height);
+	Image temp(m_width, m_height);
+
+	// Empty image
+	if (!m_width || !m_height)
+	{
+		return (temp);
+	}
+
+	// The halo of the image holds the border of the rows: no copy
+	const bool has_halo(hasHalo(aRadius, aBorderMode, aBorderValue));
+
+	// Horizontal pass: running sum along every extended row
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			std::vector<float> extended_row(m_width + 2 * aRadius);
+
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				const float* p_input(&extended_row[0]);
+				if (has_halo)
+				{
+					p_input = getRow(j) - aRadius;
+				}
+				else
+				{
+					extendRow(getRow(j), m_width, aRadius,
+						aBorderMode, aBorderValue, &extended_row[0]);
+				}
+
+				// Double precision, so the sum does not drift along the row
+				double sum(0);
+				for (unsigned int k(0); k < box_size; ++k)
+				{
+					sum += p_input[k];
+				}
+
+				float* p_output(horizontal_pass.getRow(j));
+				p_output[0] = sum;
+				for (unsigned int i(1); i < m_width; ++i)
+				{
+					sum += p_input[i + box_size - 1];
+					sum -= p_input[i - 1];
+					p_output[i] = sum;
+				}
+			}
+		});
+
+	// With a constant border, a row outside the image is constant after the first pass
+	const std::vector<float> constant_row(m_width, aBorderValue * box_size);
+	const double normalisation(1.0 / (double(box_size) * box_size));
+
+	// Accessor on a row of the first pass, whatever its index
+	auto get_row = [&](int y) -> const float*
+	{
+		if (aBorderMode == BORDER_CONSTANT && (y < 0 || y >= int(m_height)))
+		{
+			return (&constant_row[0]);
+		}
+
+		return (horizontal_pass.getRow(getBorderIndex(y, m_height, aBorderMode)));
+	};
+
+	// Vertical pass: running sums of whole rows
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			// Sums of the box_size rows around the first row of the band
+			std::vector<double> column_sum(m_width, 0);
+			for (int y(int(aFirstRow) - int(aRadius)); y <= int(aFirstRow + aRadius); ++y)
+			{
+				const float* p_row(get_row(y));
+				for (unsigned int i(0); i < m_width; ++i)
+				{
+					column_sum[i] += p_row[i];
+				}
+			}
+
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				float* p_output(temp.getRow(j));
+				for (unsigned int i(0); i < m_width; ++i)
+				{
+					p_output[i] = column_sum[i] * normalisation;
+				}
+
+				// Slide the box down by one row
+				const float* p_entering(get_row(j + aRadius + 1));
+				const float* p_leaving(get_row(int(j) - int(aRadius)));
+				for (unsigned int i(0); i < m_width; ++i)
+				{
+					column_sum[i] += p_entering[i];
+					column_sum[i] -= p_leaving[i];
+				}
+			}
+		});
+
+	return (temp);
+}
+
+
+//----------------------------------------------------------------
+bool ImageView::is8Bit() const
+//----------------------------------------------------------------
+{
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		const float* p_row(getRow(j));
+		for (unsigned int i(0); i < m_width; ++i)
+		{
+			const float value(p_row[i]);
+			if (value < 0 || value > 255 || value != float(int(value)))
+			{
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::medianFilter(unsigned int aRadius,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	// Nothing to filter
+	if (!aRadius || !m_width || !m_height)
+	{
+		return (Image(*this));
+	}
+
+	Image temp(m_width, m_height);
+
+	const unsigned int window_size(2 * aRadius + 1);
+	const unsigned int median_rank(window_size * window_size / 2);
+	const bool is_constant(aBorderMode == BORDER_CONSTANT);
+
+	// Generic data: partial sort of every neighbourhood
+	if (!is8Bit() || (is_constant &&
+		(aBorderValue < 0 || aBorderValue > 255 || aBorderValue != float(int(aBorderValue)))))
+	{
+		getThreadPool().parallelFor(0, m_height,
+			[&](unsigned int aFirstRow, unsigned int aLastRow)
+			{
+				std::vector<float> window(window_size * window_size);
+
+				for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+				{
+					for (unsigned int i(0); i < m_width; ++i)
+					{
+						std::vector<float>::iterator p_value(window.begin());
+						for (int y(int(j) - int(aRadius)); y <= int(j + aRadius); ++y)
+						{
+							for (int x(int(i) - int(aRadius)); x <= int(i + aRadius); ++x)
+							{
+								*p_value++ = getBorderPixel(x, y, aBorderMode, aBorderValue);
+							}
+						}
+
+						std::nth_element(window.begin(), window.begin() + median_rank, window.end());
+						temp.getRow(j)[i] = window[median_rank];
+					}
+				}
+			});
+
+		return (temp);
+	}
+
+	// 8-bit data: 256 fine bins, grouped in 16 coarse bins of 16 values
+	const unsigned int FINE_BINS(256), COARSE_BINS(16);
+	const unsigned char border_value(aBorderValue);
+
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			// Histograms of the window_size pixels of every column
+			std::vector<unsigned int> fine_column(m_width * FINE_BINS, 0);
+			std::vector<unsigned int> coarse_column(m_width * COARSE_BINS, 0);
+
+			// Histogram of a column outside of the image (BORDER_CONSTANT)
+			std::vector<unsigned int> fine_constant(FINE_BINS, 0);
+			std::vector<unsigned int> coarse_constant(COARSE_BINS, 0);
+			fine_constant[border_value] = window_size;
+			coarse_constant[border_value / 16] = window_size;
+
+			// Update the histogram of every column with the pixels of row y
+			auto update_columns = [&](int y, int aDelta)
+			{
+				// Constant row
+				if (is_constant && (y < 0 || y >= int(m_height)))
+				{
+					for (unsigned int i(0); i < m_width; ++i)
+					{
+						fine_column[i * FINE_BINS + border_value] += aDelta;
+						coarse_column[i * COARSE_BINS + border_value / 16] += aDelta;
+					}
+				}
+				else
+				{
+					const float* p_row(getRow(getBorderIndex(y, m_height, aBorderMode)));
+					for (unsigned int i(0); i < m_width; ++i)
+					{
+						const unsigned int value(p_row[i]);
+						fine_column[i * FINE_BINS + value] += aDelta;
+						coarse_column[i * COARSE_BINS + value / 16] += aDelta;
+					}
+				}
+			};
+
+			// Histograms of the column at x (possibly outside of the image)
+			auto get_fine = [&](int x) -> const unsigned int*
+			{
+				if (is_constant && (x < 0 || x >= int(m_width)))
+				{
+					return (&fine_constant[0]);
+				}
+				return (&fine_column[getBorderIndex(x, m_width, aBorderMode) * FINE_BINS]);
+			};
+
+			auto get_coarse = [&](int x) -> const unsigned int*
+			{
+				if (is_constant && (x < 0 || x >= int(m_width)))
+				{
+					return (&coarse_constant[0]);
+				}
+				return (&coarse_column[getBorderIndex(x, m_width, aBorderMode) * COARSE_BINS]);
+			};
+
+			// Column histograms of the first row of the band
+			for (int y(int(aFirstRow) - int(aRadius)); y <= int(aFirstRow + aRadius); ++y)
+			{
+				update_columns(y, 1);
+			}
+
+			std::vector<unsigned int> fine_window(FINE_BINS);
+			std::vector<unsigned int> coarse_window(COARSE_BINS);
+
+			// Column at which every group of 16 fine bins of the window was
+			// last brought up to date
+			std::vector<int> fine_column_index(COARSE_BINS);
+
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				// Move the column histograms down by one row
+				if (j != aFirstRow)
+				{
+					update_columns(int(j) - int(aRadius) - 1, -1);
+					update_columns(j + aRadius, 1);
+				}
+
+				// Coarse histogram of the window of the first pixel of the row.
+				// The fine bins are only updated when the median falls into
+				// their coarse bin (Perreault and Hebert)
+				std::fill(coarse_window.begin(), coarse_window.end(), 0);
+				for (int x(-int(aRadius)); x <= int(aRadius); ++x)
+				{
+					const unsigned int* p_coarse(get_coarse(x));
+					for (unsigned int k(0); k < COARSE_BINS; ++k)
+					{
+						coarse_window[k] += p_coarse[k];
+					}
+				}
+				std::fill(fine_column_index.begin(), fine_column_index.end(), -int(window_size) - 1);
+
+				for (unsigned int i(0); i < m_width; ++i)
+				{
+					// Slide the window right by one column
+					if (i)
+					{
+						const unsigned int* p_coarse_in(get_coarse(i + aRadius));
+						const unsigned int* p_coarse_out(get_coarse(int(i) - int(aRadius) - 1));
+
+						for (unsigned int k(0); k < COARSE_BINS; ++k)
+						{
+							coarse_window[k] += p_coarse_in[k] - p_coarse_out[k];
+						}
+					}
+
+					// Find the coarse bin holding the median
+					unsigned int count(0);
+					unsigned int coarse_bin(0);
+					while (count + coarse_window[coarse_bin] <= median_rank)
+					{
+						count += coarse_window[coarse_bin++];
+					}
+
+					// Bring its fine bins up to date
+					const unsigned int first_bin(coarse_bin * 16);
+					unsigned int* p_fine_window(&fine_window[first_bin]);
+					int& column_index(fine_column_index[coarse_bin]);
+					if (int(i) - column_index > int(window_size))
+					{
+						// Too old: sum the columns of the window again
+						std::fill(p_fine_window, p_fine_window + 16, 0);
+						for (int x(int(i) - int(aRadius)); x <= int(i + aRadius); ++x)
+						{
+							const unsigned int* p_fine(get_fine(x) + first_bin);
+							for (unsigned int k(0); k < 16; ++k)
+							{
+								p_fine_window[k] += p_fine[k];
+							}
+						}
+					}
+					else
+					{
+						// Slide them over the columns skipped since
+						for (int x(column_index + 1); x <= int(i); ++x)
+						{
+							const unsigned int* p_fine_in(get_fine(x + int(aRadius)) + first_bin);
+							const unsigned int* p_fine_out(get_fine(x - int(aRadius) - 1) + first_bin);
+							for (unsigned int k(0); k < 16; ++k)
+							{
+								p_fine_window[k] += p_fine_in[k] - p_fine_out[k];
+							}
+						}
+					}
+					column_index = i;
+
+					// Find the value holding the median
+					unsigned int value(first_bin);
+					while (count + fine_window[value] <= median_rank)
+					{
+						count += fine_window[value++];
+					}
+
+					temp.getRow(j)[i] = value;
+				}
+			}
+		});
+
+	return (temp);
+}
+
+
+//----------------------------------------------------------------
+void ImageView::setNumberOfThreads(unsigned int aNumberOfThreads)
+//----------------------------------------------------------------
 {
-    saveASCII(aFileName.data());
+	g_p_thread_pool.reset(new ThreadPool(aNumberOfThreads));
 }
 
 
-//------------------------------------------------
-bool Image::operator==(const Image& anImage) const
-//------------------------------------------------
+//----------------------------------------------------------------
+unsigned int ImageView::getNumberOfThreads()
+//----------------------------------------------------------------
 {
-    if (m_width != anImage.m_width)
-    {
-        return (false);
-    }
+	return (getThreadPool().getNumberOfThreads());
+}
 
-    if (m_height != anImage.m_height)
-    {
-        return (false);
-    }
 
-    float const * p_data1(m_p_image);
-    float const * p_data2(anImage.m_p_image);
-    for (unsigned int i(0); i < m_width * m_height; ++i)
-    {
-        if (std::abs(*p_data1++ - *p_data2++) > 1.0e-6)
-        {
-            return (false);
-        }
-    }
+//----------------------------------------------------------------
+ThreadPool& ImageView::getThreadPool()
+//----------------------------------------------------------------
+{
+	// Run serially by default
+	if (!g_p_thread_pool)
+	{
+		g_p_thread_pool.reset(new ThreadPool(1));
+	}
 
-    return (true);
+	return (*g_p_thread_pool);
 }
 
+
 //----------------------------------------------------------------
-float Image::getSAE(const Image& anImage) const
+void Image::setSize(unsigned int aWidth, unsigned int aHeight)
 //----------------------------------------------------------------
 {
-	if (getWidth() != anImage.getWidth() || anImage.getHeight() != anImage.getHeight())
+	// Contiguous rows
+	unsigned int halo(0);
+	unsigned int left_padding(0);
+	unsigned int stride(aWidth);
+	unsigned int buffer_size(aWidth * aHeight);
+
+	// Every row, and the first pixel of every row, starts on a cache line.
+	// The halo is on the left of the first pixel, on the right of the last
+	// one, and above and below the image
+	if (m_aligned_flag)
 	{
-		return (false);
+		halo = m_halo_capacity;
+		left_padding = (halo + g_row_alignment - 1) / g_row_alignment * g_row_alignment;
+		stride = (left_padding + aWidth + halo + g_row_alignment - 1) / g_row_alignment * g_row_alignment;
+
+		// Spare pixels to align the first row
+		buffer_size = stride * (aHeight + 2 * halo) + g_row_alignment - 1;
 	}
 
-	float const * p_data1(m_p_image);
-	float const * p_data2(anImage.m_p_image);
-	float sae_result(0);
+	// The buffer is kept if it has the right size
+	if (!m_p_buffer || m_buffer_size != buffer_size)
+	{
+		// Release memory
+		destroy();
+
+		// Recycle a buffer of a previous image if possible
+		m_p_buffer = BufferPool::allocate(buffer_size);
+		m_buffer_size = buffer_size;
+	}
 
-	for (unsigned int i(0); i < m_width * m_height; ++i)
+	float* p_first_row(m_p_buffer);
+	if (m_aligned_flag)
 	{
-		sae_result += (abs)(m_p_image[i] - anImage.m_p_image[i]);
+		const std::uintptr_t mask(g_row_alignment * sizeof(float) - 1);
+		p_first_row = reinterpret_cast<float*>((reinterpret_cast<std::uintptr_t>(m_p_buffer) + mask) & ~mask);
 	}
 
-	return(sae_result);
+	m_p_image = p_first_row + halo * stride + left_padding;
+	m_width = aWidth;
+	m_height = aHeight;
+	m_stride = stride;
+
+	// The halo does not hold the border of the new pixels
+	m_halo_size = 0;
 }
 
+
 //----------------------------------------------------------------
-float Image::getNCC(const Image& anImage) const
+void Image::setStorage(bool anAlignedFlag, unsigned int aHaloSize)
 //----------------------------------------------------------------
 {
-	if (getWidth() != anImage.getWidth() || anImage.getHeight() != anImage.getHeight())
+	// The halo needs aligned rows
+	if (!anAlignedFlag)
 	{
-		return (false);
+		aHaloSize = 0;
 	}
-	const float IMG1_AVG(getAverage());
-	const float IMG2_AVG(anImage.getAverage());
-	const float SD(getStandardDeviation() * anImage.getStandardDeviation());
-	float ncc_result(0);
-	
-	for (unsigned int i(0); i < m_width * m_height; ++i)
+
+	// Nothing to change
+	if (m_aligned_flag == anAlignedFlag && m_halo_capacity == aHaloSize)
 	{
-		ncc_result += ((m_p_image[i] - IMG1_AVG)*(anImage.m_p_image[i] - IMG2_AVG) / SD) / (m_width*m_height);
+		return;
 	}
-	
-	std::cout << ncc_result << std::endl;
-	return ncc_result*100;
+
+	// Copy the pixels into a buffer with the new layout
+	Image temp;
+	temp.m_aligned_flag = anAlignedFlag;
+	temp.m_halo_capacity = aHaloSize;
+	if (m_p_buffer)
+	{
+		temp.copy(*this);
+	}
+
+	swap(temp);
 }
 
 
 //----------------------------------------------------------------
-float Image::getAverage() const
+void Image::copy(const ImageView& anImage)
 //----------------------------------------------------------------
 {
-	float avg(0);
+	// Reuse the buffer if possible
+	setSize(anImage.getWidth(), anImage.getHeight());
 
-	for (unsigned int i(0); i < m_width*m_height; ++i) 
+	for (unsigned int j(0); j < m_height; ++j)
 	{
-		avg += m_p_image[i];
+		const float* p_row(anImage.getRow(j));
+		std::copy(p_row, p_row + m_width, getRow(j));
 	}
-
-	return (avg / (m_width*m_height));
 }
 
 
 //----------------------------------------------------------------
-float Image::getVariance() const
+void Image::accumulate(const ImageView& anImage, float aWeight)
 //----------------------------------------------------------------
 {
-	float variance(0);
-	float avg(Image::getAverage());
+	const unsigned int width(std::min(m_width, anImage.getWidth()));
+	const unsigned int height(std::min(m_height, anImage.getHeight()));
 
-	for (unsigned int i(0); i < m_width*m_height; ++i)
+	// Same width: the common area is contiguous in both images
+	if (width == m_width && width == m_stride && width == anImage.getStride())
 	{
-		variance += pow((avg - m_p_image[i]), 2); //squared
+		RowKernels::multiplyAdd(anImage.getRow(0), aWeight, m_p_image, width * height);
+	}
+	else
+	{
+		for (unsigned int j(0); j < height; ++j)
+		{
+			RowKernels::multiplyAdd(anImage.getRow(j),
+				aWeight,
+				getRow(j),
+				width);
+		}
+	}
+	m_halo_size = 0;
+
+	// anImage is smaller: only keep the common area
+	if (width != m_width || height != m_height)
+	{
+		Image temp;
+		temp.setStorage(m_aligned_flag, m_halo_capacity);
+		temp.setSize(width, height);
+		for (unsigned int j(0); j < height; ++j)
+		{
+			std::copy(getRow(j), getRow(j) + width, temp.getRow(j));
+		}
+		swap(temp);
 	}
-	
-	return variance /= (m_width*m_height);
 }
 
+
 //----------------------------------------------------------------
-float Image::getStandardDeviation() const
+float ImageView::getBorderPixel(int i, int j, BorderMode aBorderMode, float aBorderValue) const
 //----------------------------------------------------------------
 {
-	float standard_deviation(sqrt(Image::getVariance()));
-	
-	return standard_deviation;
+	// The pixel is outside of the image and a constant is used
+	if (aBorderMode == BORDER_CONSTANT &&
+		(i < 0 || j < 0 || i >= int(m_width) || j >= int(m_height)))
+	{
+		return (aBorderValue);
+	}
+
+	return (m_p_image[getBorderIndex(j, m_height, aBorderMode) * m_stride +
+		getBorderIndex(i, m_width, aBorderMode)]);
 }
 
+
 //----------------------------------------------------------------
-Image Image::blendImage(const Image& anImage, float blendRatio) const
+bool ImageView::hasHalo(unsigned int aRadius, BorderMode aBorderMode, float aBorderValue) const
 //----------------------------------------------------------------
 {
-	Image tempImage(*this);
-	float* p_temp(tempImage.m_p_image);
+	return (aRadius <= m_halo_size && aBorderMode == m_halo_mode &&
+		(aBorderMode != BORDER_CONSTANT || aBorderValue == m_halo_value));
+}
 
-	if (getWidth() != anImage.getWidth() || anImage.getHeight() != anImage.getHeight())
-	{
-		std::cout << "Images not of the same size" << std::endl;
-	}
 
-	for (unsigned int i(0); i < m_width*m_height; ++i)
+//----------------------------------------------------------------
+void ImageView::computeRange(float& aMinValue, float& aMaxValue) const
+//----------------------------------------------------------------
+{
+	// The image is empty
+	if (!m_p_image || !m_width || !m_height)
 	{
-		p_temp[i]= (m_p_image[i] + (1-blendRatio) * anImage.m_p_image[i]);
+		throw "Empty image";
 	}
-	return tempImage;
+
+	aMinValue = *m_p_image;
+	aMaxValue = *m_p_image;
+	std::mutex range_mutex;
+
+	// Every thread scans its band, then updates the range
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			float min_value(*getRow(aFirstRow));
+			float max_value(min_value);
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+			{
+				RowKernels::RowStatistics row_statistics;
+				RowKernels::getStatistics(getRow(j), m_width, 0, row_statistics);
+				min_value = std::min(min_value, row_statistics.m_min_value);
+				max_value = std::max(max_value, row_statistics.m_max_value);
+			}
+
+			std::lock_guard<std::mutex> lock(range_mutex);
+			aMinValue = std::min(aMinValue, min_value);
+			aMaxValue = std::max(aMaxValue, max_value);
+		});
 }
 
+
 //----------------------------------------------------------------
-float Image::createHistogram(const int aNumberOfBins) const
+void ImageView::accumulateHistogram(unsigned int aFirstRow,
+		unsigned int aLastRow,
+		unsigned int aNumberOfBins,
+		float aMinValue,
+		float aMaxValue,
+		unsigned int* apHistogram) const
 //----------------------------------------------------------------
 {
-	std::cout << "bins" << aNumberOfBins << std::endl;
-	//create a dynamic array with size bins
-	//int bins[bins_to_create] = 0;
-	std::vector<unsigned int> bins(aNumberOfBins, 0);
-	const float max_value(getMaxValue());
-	const float min_value(getMinValue());
-	float pixel_range((max_value - min_value)/(float) aNumberOfBins);
-	float pixel_floor(0), pixel_ceiling(0);
-	int counter(0);
-
-	pixel_floor = min_value;
-	pixel_ceiling = min_value + pixel_range;
-	for (unsigned int i(0); i < aNumberOfBins; ++i)
+	// Pixel k goes to the sub-histogram k % 4
+	std::vector<unsigned int> sub_histogram_set(4 * aNumberOfBins, 0);
+	unsigned int* p_sub_histogram_set[4] = {
+		&sub_histogram_set[0],
+		&sub_histogram_set[aNumberOfBins],
+		&sub_histogram_set[2 * aNumberOfBins],
+		&sub_histogram_set[3 * aNumberOfBins]
+	};
+
+	// A constant image goes to the first bin
+	const float scale(aMaxValue > aMinValue ? aNumberOfBins / (aMaxValue - aMinValue) : 0);
+	const unsigned int last_bin(aNumberOfBins - 1);
+
+	for (unsigned int j(aFirstRow); j < aLastRow; ++j)
 	{
-		//if(i < range)
-		for (int j(0); j < m_width*m_height; ++j)
+		const float* p_row(getRow(j));
+		for (unsigned int i(0); i < m_width; ++i)
 		{
-			if (m_p_image[j] > pixel_floor && m_p_image[j] < pixel_ceiling)
+			const float value(p_row[i]);
+
+			// The pixels outside of the range (and NaN) are not counted
+			if (value >= aMinValue && value <= aMaxValue)
 			{
-				++counter;
+				// The maximum belongs to the last bin
+				const unsigned int bin(std::min(last_bin, (unsigned int)((value - aMinValue) * scale)));
+				++p_sub_histogram_set[i & 3][bin];
 			}
 		}
-		bins[i] = counter;
-		counter = 0;
-		pixel_floor = pixel_ceiling;
-		pixel_ceiling = pixel_floor + pixel_range;
 	}
 
-	for (int i(0); i < aNumberOfBins; ++i) {
-		std::cout << i << ": "<< bins[i] << " ," << std::endl;
+	// Merge the sub-histograms
+	for (unsigned int i(0); i < aNumberOfBins; ++i)
+	{
+		apHistogram[i] += p_sub_histogram_set[0][i] + p_sub_histogram_set[1][i] +
+				p_sub_histogram_set[2][i] + p_sub_histogram_set[3][i];
 	}
-	//delete[] bins;
-	return 0;
 }
 
+
 //----------------------------------------------------------------
-unsigned int* Image::getHistogram(unsigned int aNumberOfBins) const
+void ImageView::accumulate8BitHistogram(unsigned int aFirstRow,
+		unsigned int aLastRow,
+		unsigned int* apHistogram) const
 //----------------------------------------------------------------
 {
-	unsigned int* histogram_data(new unsigned int[aNumberOfBins]);
-	std::fill_n(histogram_data, aNumberOfBins, 0);
-	const float min_value(getMinValue());
-	float range = getMaxValue() - min_value;
-	float top;
-	int temp;
+	unsigned int p_sub_histogram_set[4][256] = {};
 
-	for (int i(0); i < m_height*m_width; i++)
+	// The pixels of a row are rounded and clamped to 8 bits at once
+	std::vector<std::uint8_t> byte_row(m_width);
+
+	for (unsigned int j(aFirstRow); j < aLastRow; ++j)
 	{
-		top = m_p_image[i] - min_value;
-		temp = aNumberOfBins * (top / range);
-		if (temp < aNumberOfBins)
-		{
-			histogram_data[temp]++;
-		} 
-		else if(temp == aNumberOfBins)
+		RowKernels::convert(getRow(j), byte_row.data(), m_width);
+		for (unsigned int i(0); i < m_width; ++i)
 		{
-			histogram_data[temp - 1]++;
+			++p_sub_histogram_set[i & 3][byte_row[i]];
 		}
 	}
-	return histogram_data;
+
+	// Merge the sub-histograms
+	for (unsigned int i(0); i < 256; ++i)
+	{
+		apHistogram[i] += p_sub_histogram_set[0][i] + p_sub_histogram_set[1][i] +
+				p_sub_histogram_set[2][i] + p_sub_histogram_set[3][i];
+	}
 }
 
+
 //----------------------------------------------------------------
-void Image::writeHistogram(unsigned int aNumberOfBins, const std::string& aFileName) const
+template<typename RowKernel> void ImageView::filterInterior_3x3(Image& anOutput,
+	RowKernel aRowKernel,
+	unsigned int aFirstRow,
+	unsigned int aLastRow) const
 //----------------------------------------------------------------
 {
-	writeHistogram(aNumberOfBins, aFileName.data());
+	// Not enough pixels to have an interior
+	if (m_width < 3)
+	{
+		return;
+	}
+
+	// Only rows with a neighbour above and below are processed
+	aFirstRow = std::max(aFirstRow, 1u);
+	aLastRow = std::min(aLastRow, m_height - 1);
+
+	for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+	{
+		// Rows of the neighbourhood
+		const float* p_above(getRow(j - 1));
+		const float* p_row(p_above + m_stride);
+		const float* p_below(p_row + m_stride);
+		float* p_output(anOutput.getRow(j));
+
+		// No bound check: every neighbour exists
+		aRowKernel(p_above + 1, p_row + 1, p_below + 1, p_output + 1, m_width - 2);
+	}
 }
+
+
 //----------------------------------------------------------------
-void Image::writeHistogram(unsigned int aNumberOfBins, const char * aFileName) const
+template<typename Kernel> void ImageView::filterBorder_3x3(Image& anOutput,
+	Kernel aKernel,
+	BorderMode aBorderMode,
+	float aBorderValue) const
 //----------------------------------------------------------------
 {
-	std::ofstream output_stream(aFileName); // Open the file
-	if (!output_stream.is_open()) // The file is not open
+	for (unsigned int j(0); j < m_height; ++j)
 	{
-		std::string error_message("Cannot open file (output.dat).");
-		throw (error_message); // Throw an error
+		// Every pixel of the first and last rows, the first and last pixels otherwise
+		const bool is_border_row(j == 0 || j == m_height - 1);
+		const unsigned int step(is_border_row || m_width < 2 ? 1 : m_width - 1);
+
+		for (unsigned int i(0); i < m_width; i += step)
+		{
+			float kernel[9];
+			float* p_kernel(kernel);
+			for (int y(int(j) - 1); y <= int(j) + 1; ++y)
+			{
+				for (int x(int(i) - 1); x <= int(i) + 1; ++x)
+				{
+					*p_kernel++ = getBorderPixel(x, y, aBorderMode, aBorderValue);
+				}
+			}
+
+			anOutput.getRow(j)[i] = (anOutput.*aKernel)(
+				kernel[0], kernel[1], kernel[2],
+				kernel[3], kernel[4], kernel[5],
+				kernel[6], kernel[7], kernel[8]);
+		}
 	}
+}
 
-	float range = getMaxValue() - getMinValue();
-	float bins = range / aNumberOfBins;
-	float minBinValue = getMinValue();
-	unsigned int* p_histogram = getHistogram(aNumberOfBins);
-	output_stream << "\"Min bin value\"" << " " << "\"Count\"" << std::endl;
-	for (int i = 0; i< aNumberOfBins; i++)
-	{
 
-		output_stream << minBinValue << " " << p_histogram[i] << std::endl;
-		minBinValue += bins;
+//----------------------------------------------------------------
+template<typename Kernel, typename RowKernel> void ImageView::apply_3x3(Image& anOutput,
+	Kernel aKernel,
+	RowKernel aRowKernel,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	// The halo of the image holds the border: every pixel is processed
+	// without bound check, there is no border pass
+	if (hasHalo(1, aBorderMode, aBorderValue))
+	{
+		getThreadPool().parallelFor(0, m_height,
+			[&](unsigned int aFirstRow, unsigned int aLastRow)
+			{
+				for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+				{
+					const float* p_row(getRow(j));
+					aRowKernel(p_row - m_stride, p_row, p_row + m_stride, anOutput.getRow(j), m_width);
+				}
+			});
+
+		return;
 	}
 
-	output_stream.close();
+	// Horizontal bands of the interior in parallel. A band reads one row
+	// above and below itself (its halo), but only writes its own rows.
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			filterInterior_3x3(anOutput, aRowKernel, aFirstRow, aLastRow);
+		});
+
+	// The border ring is small, process it serially
+	filterBorder_3x3(anOutput, aKernel, aBorderMode, aBorderValue);
 }
 
 
+//----------------------------------------------------------------
+Image ImageView::gradient(GradientOperator anOperator,
+	GradientNorm aNorm,
+	Image* apDirection,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	std::vector<Image> magnitude_set;
+	std::vector<Image> direction_set;
+	gradients(std::vector<GradientOperator>(1, anOperator),
+		magnitude_set,
+		apDirection ? &direction_set : 0,
+		aNorm, aBorderMode, aBorderValue);
+
+	if (apDirection)
+	{
+		*apDirection = std::move(direction_set[0]);
+	}
+
+	return (std::move(magnitude_set[0]));
+}
+
 
 //----------------------------------------------------------------
-Image Image::segmentImage(const float threshold) const
+void ImageView::gradients(const std::vector<GradientOperator>& anOperatorSet,
+	std::vector<Image>& aMagnitudeSet,
+	std::vector<Image>* apDirectionSet,
+	GradientNorm aNorm,
+	BorderMode aBorderMode,
+	float aBorderValue) const
 //----------------------------------------------------------------
 {
-	Image tempImage(*this);
-	float* p_temp(tempImage.m_p_image);
-	const float BLACK = 0;
-	const float WHITE = 255;
-	
-	for (unsigned int i(0); i < m_width*m_height; ++i)
+	const unsigned int operator_count(anOperatorSet.size());
+	const bool is_l2_norm(aNorm == GRADIENT_L2);
+
+	// The current view is in an output: compute into new images
+	bool is_overlapping(false);
+	for (unsigned int k(0); k < aMagnitudeSet.size(); ++k)
+	{
+		is_overlapping = is_overlapping || isOverlapping(aMagnitudeSet[k]);
+	}
+	for (unsigned int k(0); apDirectionSet && k < apDirectionSet->size(); ++k)
+	{
+		is_overlapping = is_overlapping || isOverlapping((*apDirectionSet)[k]);
+	}
+
+	if (is_overlapping)
 	{
-		if (m_p_image[i] < threshold)
+		// The new images are stored as the images of the caller
+		std::vector<Image> magnitude_set(aMagnitudeSet.size());
+		std::vector<Image> direction_set(apDirectionSet ? apDirectionSet->size() : 0);
+		for (unsigned int k(0); k < magnitude_set.size(); ++k)
 		{
-			tempImage.m_p_image[i] = BLACK;
-		} 
-		
-		else if (m_p_image[i] > threshold)
+			magnitude_set[k].setStorage(aMagnitudeSet[k].m_aligned_flag, aMagnitudeSet[k].m_halo_capacity);
+		}
+		for (unsigned int k(0); k < direction_set.size(); ++k)
 		{
-			tempImage.m_p_image[i] = WHITE;
+			direction_set[k].setStorage((*apDirectionSet)[k].m_aligned_flag, (*apDirectionSet)[k].m_halo_capacity);
 		}
-		else
+
+		gradients(anOperatorSet, magnitude_set, apDirectionSet ? &direction_set : 0,
+			aNorm, aBorderMode, aBorderValue);
+
+		aMagnitudeSet.swap(magnitude_set);
+		if (apDirectionSet)
 		{
-			tempImage.m_p_image[i] = m_p_image[i];
+			apDirectionSet->swap(direction_set);
 		}
+		return;
 	}
-	
-	return tempImage;
-}
-//----------------------------------------------------------------
-Image Image::selectFunction_3x3(int aFunctionId) const {
-	//----------------------------------------------------------------
-	Image temp(*this);
-	//float* p_temp(temp.m_p_image);//pointer
-	const int MIN_WIDTH(m_width - 1), MIN_HEIGHT(m_height - 1), KERNEL_SIZE(9);
-	int x(0);
-	int y(0);
-	float kernel[KERNEL_SIZE];
-	//std::cout << "m_width: " << m_width << std::endl;
-	//std::cout << "m_height: " << m_height << std::endl;
-	while (y++ < m_height - 1) {
-
-		for (x = 0; x < m_width - 1; x++) {
-			//block below selects appropriate values and deals with corners
-			//regular case
-			if (y >= 1 && x >= 1 && y < m_height - 1 && x < m_width - 1)
-			{
-				kernel[0] = getPixel(x - 1, y - 1); kernel[1] = getPixel(x - 1, y); kernel[2] = getPixel(x - 1, y + 1);
-				kernel[3] = getPixel(x, y - 1); kernel[4] = getPixel(x + 1, y - 1); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x + 1, y); kernel[7] = getPixel(x, y + 1); kernel[8] = getPixel(x + 1, y + 1);
-			}
-			//upper left edge
-			else if (y == 0 && x == 0)
-			{
-				kernel[0] = getPixel(x, y); kernel[1] = getPixel(x, y); kernel[2] = getPixel(x, y);
-				kernel[3] = getPixel(x, y); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x + 1, y); kernel[7] = getPixel(x, y + 1); kernel[8] = getPixel(x + 1, y + 1);
-			}
-			//left edge
-			else if (x == 0 && (y != 0 && y != m_height - 1))
-			{
-				kernel[0] = getPixel(x, y); kernel[1] = getPixel(x, y); kernel[2] = getPixel(x, y);
-				kernel[3] = getPixel(x, y - 1); kernel[4] = getPixel(x + 1, y - 1); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x + 1, y); kernel[7] = getPixel(x, y + 1); kernel[8] = getPixel(x + 1, y + 1);
-			}
-			//bottom right edge
-			else if (x == m_width - 1 && y == m_height - 1)
-			{
-				kernel[0] = getPixel(x - 1, y - 1); kernel[1] = getPixel(x - 1, y); kernel[2] = getPixel(x, y);
-				kernel[3] = getPixel(x, y - 1); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x, y); kernel[7] = getPixel(x, y); kernel[8] = getPixel(x, y);
-			}
-			//bottom left corner
-			else if (y == m_height - 1 && x == 0)
-			{
-				kernel[0] = getPixel(x, y); kernel[1] = getPixel(x, y); kernel[2] = getPixel(x, y);
-				kernel[3] = getPixel(x, y); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x, y - 1); kernel[7] = getPixel(x + 1, y - 1); kernel[8] = getPixel(x + 1, y);
-			}
-			//top right corner
-			else if (x == m_width - 1 && y == 0)
+
+	// Every pixel is overwritten, the images of the caller are reused if possible
+	aMagnitudeSet.resize(operator_count);
+	for (unsigned int k(0); k < operator_count; ++k)
+	{
+		aMagnitudeSet[k].setSize(m_width, m_height);
+	}
+
+	if (apDirectionSet)
+	{
+		apDirectionSet->resize(operator_count);
+		for (unsigned int k(0); k < operator_count; ++k)
+		{
+			(*apDirectionSet)[k].setSize(m_width, m_height);
+		}
+	}
+
+	// Nothing to compute
+	if (!operator_count)
+	{
+		return;
+	}
+
+	// The operators and their outputs
+	std::vector<RowKernels::GradientOutput> output_set(operator_count);
+	for (unsigned int k(0); k < operator_count; ++k)
+	{
+		switch (anOperatorSet[k])
+		{
+			case(GRADIENT_PREWITT): output_set[k].m_operator = RowKernels::PREWITT; break;
+			case(GRADIENT_SOBEL): output_set[k].m_operator = RowKernels::SOBEL; break;
+			case(GRADIENT_SCHARR): output_set[k].m_operator = RowKernels::SCHARR; break;
+			case(GRADIENT_ROBERTS): output_set[k].m_operator = RowKernels::ROBERTS; break;
+			default: throw "Gradient operator not found";
+		}
+	}
+
+	// The outputs usually share their stride (e.g. they are all packed): a
+	// pixel then has the same index in every output. Otherwise a copy of
+	// the outputs is pointed at every row.
+	const unsigned int output_stride(aMagnitudeSet[0].getStride());
+	bool is_same_stride(true);
+	for (unsigned int k(0); k < operator_count; ++k)
+	{
+		output_set[k].m_p_magnitude = aMagnitudeSet[k].getRow(0);
+		output_set[k].m_p_direction = apDirectionSet ? (*apDirectionSet)[k].getRow(0) : 0;
+
+		is_same_stride = is_same_stride && aMagnitudeSet[k].getStride() == output_stride &&
+			(!apDirectionSet || (*apDirectionSet)[k].getStride() == output_stride);
+	}
+
+	// Compute aCount pixels of row j from the pixel i
+	auto process_row = [&](const float* apAbove,
+		const float* apRow,
+		const float* apBelow,
+		unsigned int i,
+		unsigned int j,
+		unsigned int aCount,
+		std::vector<RowKernels::GradientOutput>& aRowOutputSet)
+	{
+		if (is_same_stride)
+		{
+			RowKernels::gradient_3x3(apAbove, apRow, apBelow,
+				&output_set[0], operator_count, j * output_stride + i,
+				aCount, is_l2_norm);
+		}
+		else
+		{
+			for (unsigned int k(0); k < operator_count; ++k)
 			{
-				kernel[0] = getPixel(x, y); kernel[1] = getPixel(x, y); kernel[2] = getPixel(x, y);
-				kernel[3] = getPixel(x, y); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x - 1, y); kernel[7] = getPixel(x - 1, y + 1); kernel[8] = getPixel(x, y + 1);
+				aRowOutputSet[k].m_operator = output_set[k].m_operator;
+				aRowOutputSet[k].m_p_magnitude = aMagnitudeSet[k].getRow(j);
+				aRowOutputSet[k].m_p_direction = apDirectionSet ? (*apDirectionSet)[k].getRow(j) : 0;
 			}
-			//right side no corners
-			else if (x == m_width - 1 && (y != 0 && y != m_height - 1))
+
+			RowKernels::gradient_3x3(apAbove, apRow, apBelow,
+				&aRowOutputSet[0], operator_count, i,
+				aCount, is_l2_norm);
+		}
+	};
+
+	// The halo holds the border: every row is processed without bound check
+	if (hasHalo(1, aBorderMode, aBorderValue))
+	{
+		getThreadPool().parallelFor(0, m_height,
+			[&](unsigned int aFirstRow, unsigned int aLastRow)
 			{
-				kernel[0] = getPixel(x - 1, y - 1); kernel[1] = getPixel(x - 1, y); kernel[2] = getPixel(x - 1, y + 1);
-				kernel[3] = getPixel(x, y - 1); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x, y); kernel[7] = getPixel(x, y + 1); kernel[8] = getPixel(x, y);
-			}
-			//bottom side
-			else if (y == m_height - 1 && (x != 0 && x != m_width - 1))
+				std::vector<RowKernels::GradientOutput> row_output_set(is_same_stride ? 0 : operator_count);
+
+				for (unsigned int j(aFirstRow); j < aLastRow; ++j)
+				{
+					const float* p_row(getRow(j));
+					process_row(p_row - m_stride, p_row, p_row + m_stride, 0, j, m_width, row_output_set);
+				}
+			});
+
+		return;
+	}
+
+	// Horizontal bands of the interior in parallel
+	getThreadPool().parallelFor(0, m_height,
+		[&](unsigned int aFirstRow, unsigned int aLastRow)
+		{
+			if (m_width < 3)
 			{
-				kernel[0] = getPixel(x - 1, y - 1); kernel[1] = getPixel(x - 1, y); kernel[2] = getPixel(x + 1, y - 1);
-				kernel[3] = getPixel(x, y - 1); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x + 1, y); kernel[7] = getPixel(x, y); kernel[8] = getPixel(x, y);
+				return;
 			}
-			//top side
-			else if (y == 0 && (x != 0 && x != m_width - 1))
+
+			aFirstRow = std::max(aFirstRow, 1u);
+			aLastRow = std::min(aLastRow, m_height - 1);
+
+			std::vector<RowKernels::GradientOutput> row_output_set(is_same_stride ? 0 : operator_count);
+
+			for (unsigned int j(aFirstRow); j < aLastRow; ++j)
 			{
-				kernel[0] = getPixel(x, y); kernel[1] = getPixel(x - 1, y); kernel[2] = getPixel(x - 1, y + 1);
-				kernel[3] = getPixel(x, y); kernel[4] = getPixel(x, y); kernel[5] = getPixel(x, y);
-				kernel[6] = getPixel(x + 1, y); kernel[7] = getPixel(x, y + 1); kernel[8] = getPixel(x + 1, y + 1);
+				const float* p_row(getRow(j));
+				process_row(p_row + 1 - m_stride, p_row + 1, p_row + 1 + m_stride, 1, j, m_width - 2, row_output_set);
 			}
-			else { std::cout << "something is amiss here" << std::endl; }
+		});
 
-			//get 1D location
-			int i = y * m_width + x;
-			//storage variables for kernel entries
-			float k_val0 = kernel[0], k_val1 = kernel[1], k_val2 = kernel[2], k_val3 = kernel[3], k_val4 = kernel[4], k_val5 = kernel[5],
-			k_val6 = kernel[6], k_val7 = kernel[7], k_val8 = kernel[8];
-			
-			//pixel to be added to temp image
-			float aPixelValue(0);
-			switch (aFunctionId)//function id selects function
+	// The border ring, one pixel at a time with the same code
+	std::vector<RowKernels::GradientOutput> row_output_set(is_same_stride ? 0 : operator_count);
+	for (unsigned int j(0); j < m_height; ++j)
+	{
+		const bool is_border_row(j == 0 || j == m_height - 1);
+		const unsigned int step(is_border_row || m_width < 2 ? 1 : m_width - 1);
+
+		for (unsigned int i(0); i < m_width; i += step)
+		{
+			float neighbourhood[3][3];
+			for (int y(0); y < 3; ++y)
 			{
-				case(0): aPixelValue = temp.filter_Median(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;	//median filter
-				case(1): aPixelValue = temp.filter_Laplacian(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break; //laplacian edge detection
-				case(2): aPixelValue = temp.blur_Gaussian(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;	//Gaussian blur
-				case(3): aPixelValue = temp.blur_Box(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;		//box blur
-				case(4): aPixelValue = temp.sharpenImg(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;		//sharpen
-				case(5): aPixelValue = temp.filter_Prewitt(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;	//prewitt operator
-				case(6): aPixelValue = temp.filter_Sobel(k_val0, k_val1, k_val2, k_val3, k_val4, k_val5, k_val6, k_val7, k_val8); break;	//sobel operator
-				default: std::cout << "Method ID not found" << std::endl; break;
-				//end program
+				for (int x(0); x < 3; ++x)
+				{
+					neighbourhood[y][x] = getBorderPixel(int(i) + x - 1, int(j) + y - 1, aBorderMode, aBorderValue);
+				}
 			}
-			//add new pixel value to temp image
-			temp.m_p_image[i] = aPixelValue;
-		} // end of x iterator
-	} // end of y iterator
+
+			process_row(&neighbourhood[0][1], &neighbourhood[1][1], &neighbourhood[2][1], i, j, 1, row_output_set);
+		}
+	}
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::sobelGradient(GradientNorm aNorm,
+	Image* apDirection,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	return (gradient(GRADIENT_SOBEL, aNorm, apDirection, aBorderMode, aBorderValue));
+}
+
+
+//----------------------------------------------------------------
+Image ImageView::selectFunction_3x3(int aFunctionId,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	Image temp;
+	selectFunction_3x3(aFunctionId, temp, aBorderMode, aBorderValue);
+
 	//return temp image when done
 	return (temp);
 }
 
+
+//----------------------------------------------------------------
+void ImageView::selectFunction_3x3(int aFunctionId,
+	Image& anOutput,
+	BorderMode aBorderMode,
+	float aBorderValue) const
+//----------------------------------------------------------------
+{
+	// The neighbours of a pixel would be overwritten before being read
+	if (isOverlapping(anOutput))
+	{
+		Image temp;
+		temp.setStorage(anOutput.m_aligned_flag, anOutput.m_halo_capacity);
+		selectFunction_3x3(aFunctionId, temp, aBorderMode, aBorderValue);
+		anOutput.swap(temp);
+		return;
+	}
+
+	// Every pixel is overwritten, reuse the buffer if possible
+	Image& temp(anOutput);
+	temp.setSize(m_width, m_height);
+
+	// The neighbourhood is passed in row-major order:
+	// n0 n1 n2 (row above), n3 n4 n5 (current row), n6 n7 n8 (row below)
+	switch (aFunctionId)//function id selects function
+	{
+		case(MEDIAN_FILTER): apply_3x3(temp, &ImageView::filter_Median, MedianRowKernel(), aBorderMode, aBorderValue); break;		//median filter
+		case(LAPLACIAN_FILTER): apply_3x3(temp, &ImageView::filter_Laplacian, LinearRowKernel(g_laplacian_kernel), aBorderMode, aBorderValue); break;		//laplacian edge detection
+		case(GAUSSIAN_BLUR): apply_3x3(temp, &ImageView::blur_Gaussian, LinearRowKernel(g_gaussian_kernel, g_gaussian_divisor), aBorderMode, aBorderValue); break;	//Gaussian blur
+		case(BOX_BLUR): apply_3x3(temp, &ImageView::blur_Box, LinearRowKernel(g_box_kernel, g_box_divisor), aBorderMode, aBorderValue); break;		//box blur
+		case(SHARPEN_FILTER): apply_3x3(temp, &ImageView::sharpenImg, LinearRowKernel(g_sharpen_kernel), aBorderMode, aBorderValue); break;				//sharpen
+		case(PREWITT_FILTER): apply_3x3(temp, &ImageView::filter_Prewitt, GradientRowKernel(RowKernels::PREWITT), aBorderMode, aBorderValue); break;	//prewitt operator
+		case(SOBEL_FILTER): apply_3x3(temp, &ImageView::filter_Sobel, GradientRowKernel(RowKernels::SOBEL), aBorderMode, aBorderValue); break;		//sobel operator
+		default: throw "Method ID not found";
+	}
+}
+
 //----------------------------------------------------------------
-float Image::filter_Median(float n0, float n1, float n2, float n3, 
+float ImageView::filter_Median(float n0, float n1, float n2, float n3, 
 	float n4, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	int median(0);
 	//kernel: original values x 1
 	float kernel[9] = { n0,n1,n2,n3,n4,n5,n6,n7,n8 };
-	//sort first to last
-	std::sort(kernel, kernel + 9);
-	//kernel median value
-	median = kernel[4];
-	//return median filter
-	return median;
+	//kernel median value (sorting network, no full sort)
+	return RowKernels::getMedian9(kernel);
 }
 
-//rename to laplacian
 //----------------------------------------------------------------
-float Image::filter_Laplacian(float n0, float n1, float n2, float n3,
+float ImageView::filter_Laplacian(float n0, float n1, float n2, float n3,
 	float n4, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	//inage data in array
-	float size(9);
 	//image data
 	float imageData[9] = { n0, n1, n2, n3, n4, n5, n6, n7, n8 };
-	//kernel for edge detection laplacian
-	float kernel[9] = { 0, 1, 0, 1, -4, 1, 0, 1, 0};
-	int aPixelValue(0);
-	float sum1, sum2;
+	float aPixelValue(0);
 
-	//multiplies each kernel enty with each pixel
-	for (int i(0); i < size; i++) {
-		imageData[i] *= kernel[i];
-		//sums values
-		aPixelValue += imageData[i];
+	//multiplies each kernel enty with each pixel and sums values
+	for (int i(0); i < 9; i++) {
+		aPixelValue += imageData[i] * g_laplacian_kernel[i];
 	}
 	//returns sum
 	return aPixelValue;
 }
 
 //----------------------------------------------------------------
-int Image::filter_Sobel(float n0, float n1, float n2, float n3,
-	float n4, float n5, float n6, float n7, float n8)
+float ImageView::filter_Sobel(float n0, float n1, float n2, float n3,
+	float /*n4*/, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {	
-	//sobel kernel for x axis
-	float kernel_X[9] = {1, 2, 1, 0 ,0 , 0, -1, -2, -1};
-	//sobel kernel for y axis
-	float kernel_Y[9] = {1, 0, -1, 2 , 0 , -2, 1, 0, -1};
-	//original image data
-	float imageData[9] = {n1,n2,n3,n4,n5,n6,n7,n8,};
-	//sum of first kernel
-	float kernelSum_1(0);
-	float kernelSum_2(0);
-	float aPixelValue(0);
-	float normalize(0);
-
-
-	for (int i(0); i < 9; i++)
-	{
-		kernelSum_1 += imageData[i] * kernel_X[i];
-		kernelSum_2 += imageData[i] * kernel_Y[i];
-	}
-	//return new pixel value
-	aPixelValue = abs(kernelSum_1) + abs(kernelSum_2);
-	//return new pixel value
-	return aPixelValue;
+	//horizontal derivative of each row, smoothed vertically
+	float kernelSum_1(n2 - n0);
+	kernelSum_1 = kernelSum_1 + 2 * (n5 - n3);
+	kernelSum_1 = kernelSum_1 + (n8 - n6);
+	//vertical derivative of each column, smoothed horizontally
+	float kernelSum_2(n6 - n0);
+	kernelSum_2 = kernelSum_2 + 2 * (n7 - n1);
+	kernelSum_2 = kernelSum_2 + (n8 - n2);
+	//return new pixel value (same operations as RowKernels::gradient_3x3)
+	return std::fabs(kernelSum_1) + std::fabs(kernelSum_2);
 }
 
 //----------------------------------------------------------------
-float Image::filter_Prewitt(float n0, float n1, float n2, float n3,
-	float n4, float n5, float n6, float n7, float n8)
+float ImageView::filter_Prewitt(float n0, float n1, float n2, float n3,
+	float /*n4*/, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	//image data
-	float imageData[9] = { n0, n1, n2, n3, n4, n5, n6, n7, n8 };
-	//prewitt kernel for x axis
-	float kernel_X[9] = { 1, 0, -1,  1,  0,  -1,  1,  0, -1 };
-	//prewitt kernel for y axis
-	float kernel_Y[9] = {1,  1,  1,  0,  0,  0,-  1, -1, -1};
-	float kernelSum_1(0), kernelSum_2(0), aPixelValue(0);
-	//get kernel sums and multiply data with kernel
-	for(int i(0); i < 9; i++)
-	{
-		kernelSum_1 += imageData[i] * kernel_X[i];
-		kernelSum_2 += imageData[i] * kernel_Y[i];
-	}
-	//get absolute sum of both
-	aPixelValue = abs(kernelSum_1) + abs(kernelSum_2);
-	//return new pixel value
-	return aPixelValue;
+	//horizontal derivative of each row, summed vertically
+	float kernelSum_1(n2 - n0);
+	kernelSum_1 = kernelSum_1 + (n5 - n3);
+	kernelSum_1 = kernelSum_1 + (n8 - n6);
+	//vertical derivative of each column, summed horizontally
+	float kernelSum_2(n6 - n0);
+	kernelSum_2 = kernelSum_2 + (n7 - n1);
+	kernelSum_2 = kernelSum_2 + (n8 - n2);
+	//return new pixel value (same operations as RowKernels::gradient_3x3)
+	return std::fabs(kernelSum_1) + std::fabs(kernelSum_2);
 }
 //----------------------------------------------------------------
-float Image::blur_Box(float n0, float n1, float n2, float n3, float n4,
-	float n5, float n6, float n7, float n8) //vector
+float ImageView::blur_Box(float n0, float n1, float n2, float n3, float n4,
+	float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	float size(9);
 	float imageData[9] = { n0, n1, n2, n3, n4, n5, n6, n7, n8 };
 	float aPixelValue(0);
 	//get get total sum of all kernel data
-	for (int i(0); i < size; i++) {
-		aPixelValue += imageData[i];
+	for (int i(0); i < 9; i++) {
+		aPixelValue += imageData[i] * g_box_kernel[i];
 	}
 	//normalize
-	aPixelValue /= size;
+	aPixelValue /= g_box_divisor;
 	//return new pixel value
 	return aPixelValue;
 }
 //----------------------------------------------------------------
-float Image::blur_Gaussian(float n0, float n1, float n2, float n3, 
+float ImageView::blur_Gaussian(float n0, float n1, float n2, float n3, 
 	float n4, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	float size(9);
 	//original data
 	float imageData[9] = { n0, n1, n2, n3, n4, n5, n6, n7, n8 };
-	//gaussian kernel
-	float kernel[9] = { 1, 2, 1, 2, 4, 2, 1, 2, 1 };
 	float aPixelValue(0);
 	//multiply original data with kernel and sum
-	for (int i(0); i < size; i++) 
+	for (int i(0); i < 9; i++) 
 	{
-		imageData[i] *= kernel[i];
-		aPixelValue += imageData[i];
+		aPixelValue += imageData[i] * g_gaussian_kernel[i];
 	}
 	//normalize
-	aPixelValue /= 16;
+	aPixelValue /= g_gaussian_divisor;
 	//return new pixel value
 	return aPixelValue;
 }
 //----------------------------------------------------------------
-float Image::sharpenImg(float n0, float n1, float n2, float n3, 
-	float n4, float n5, float n6, float n7, float n8) // alpha
+float ImageView::sharpenImg(float n0, float n1, float n2, float n3, 
+	float n4, float n5, float n6, float n7, float n8)
 //----------------------------------------------------------------
 {
-	float size(9);
 	//orginal data
 	float imageData[9] = { n0, n1, n2, n3, n4, n5, n6, n7, n8 };
-	//sharpen kernel
-	float kernel[9] = {0, -1, 0, -1, 5, -1, 0, -1, 0};
 	float aPixelValue(0);
 	//multiply each pixel in original data with kernel and compute sum
 	for (int i(0); i < 9; i++) {
-		imageData[i] *= kernel[i];
-		aPixelValue += imageData[i];
+		aPixelValue += imageData[i] * g_sharpen_kernel[i];
 	}
 	//return new value
 	return aPixelValue;
-}
\ No newline at end of file
+}
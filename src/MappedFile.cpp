@@ -0,0 +1,279 @@
+/**
+********************************************************************************
+*
+*   @file       MappedFile.cpp
+*
+*   @brief      Class to read a file through a memory mapping.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h> // Header file for open
+#include <sys/mman.h> // Header file for mmap/munmap
+#include <sys/stat.h> // Header file for fstat
+#include <unistd.h> // Header file for close
+#endif
+
+#include <cctype> // Header file for isspace/isdigit
+#include <sstream> // Header file for stringstream
+
+#include "MappedFile.h"
+
+
+//******************************************************************************
+//  Functions
+//******************************************************************************
+
+//-----------------------
+MappedFile::MappedFile():
+//-----------------------
+        m_p_data(0),
+        m_size(0)
+#ifdef _WIN32
+        , m_p_mapping(0)
+#endif
+//-----------------------
+{}
+
+
+//-----------------------
+MappedFile::~MappedFile()
+//-----------------------
+{
+    close();
+}
+
+
+//------------------------------------------
+bool MappedFile::open(const char* aFileName)
+//------------------------------------------
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file(CreateFileA(aFileName, GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0));
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return (false);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return (false);
+    }
+    m_size = std::size_t(size.QuadPart);
+
+    // An empty file cannot be mapped
+    if (m_size)
+    {
+        m_p_mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+        if (m_p_mapping)
+        {
+            m_p_data = static_cast<const unsigned char*>(MapViewOfFile(m_p_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(file);
+#else
+    const int file(::open(aFileName, O_RDONLY));
+    if (file < 0)
+    {
+        return (false);
+    }
+
+    struct stat status;
+    if (fstat(file, &status) || !S_ISREG(status.st_mode))
+    {
+        ::close(file);
+        return (false);
+    }
+    m_size = std::size_t(status.st_size);
+
+    // An empty file cannot be mapped
+    if (m_size)
+    {
+        void* p_data(mmap(0, m_size, PROT_READ, MAP_PRIVATE, file, 0));
+        if (p_data != MAP_FAILED)
+        {
+            // The file is read from the start to the end
+            madvise(p_data, m_size, MADV_SEQUENTIAL);
+            m_p_data = static_cast<const unsigned char*>(p_data);
+        }
+    }
+
+    // The mapping keeps the file open
+    ::close(file);
+#endif
+
+    // The mapping failed
+    if (m_size && !m_p_data)
+    {
+        close();
+        return (false);
+    }
+
+    return (true);
+}
+
+
+//----------------------
+void MappedFile::close()
+//----------------------
+{
+#ifdef _WIN32
+    if (m_p_data)
+    {
+        UnmapViewOfFile(m_p_data);
+    }
+
+    if (m_p_mapping)
+    {
+        CloseHandle(m_p_mapping);
+        m_p_mapping = 0;
+    }
+#else
+    if (m_p_data)
+    {
+        munmap(const_cast<unsigned char*>(m_p_data), m_size);
+    }
+#endif
+
+    m_p_data = 0;
+    m_size = 0;
+}
+
+
+//----------------------------------------------
+const unsigned char* MappedFile::getData() const
+//----------------------------------------------
+{
+    return (m_p_data);
+}
+
+
+//-------------------------------------
+std::size_t MappedFile::getSize() const
+//-------------------------------------
+{
+    return (m_size);
+}
+
+
+//-------------------------------------------------------------------------------
+ImageView MappedFile::getRawView(unsigned int aWidth, unsigned int aHeight) const
+//-------------------------------------------------------------------------------
+{
+    // The size is not correct
+    if (std::size_t(aWidth) * aHeight * sizeof(float) != m_size)
+    {
+        std::stringstream error_message;
+        error_message << "The size of the file is not " << aWidth << "x" << aHeight;
+
+        throw error_message.str();
+    }
+
+    // The mapping starts at a page boundary: the floats are aligned
+    return (ImageView(reinterpret_cast<const float*>(m_p_data), aWidth, aHeight));
+}
+
+
+//------------------------------------------------------
+bool MappedFile::readPGMHeader(PGMHeader& aHeader) const
+//------------------------------------------------------
+{
+    // The image type
+    if (m_size < 3 || m_p_data[0] != 'P' || (m_p_data[1] != '2' && m_p_data[1] != '5'))
+    {
+        return (false);
+    }
+    aHeader.m_is_binary = (m_p_data[1] == '5');
+
+    // The image size and the max value
+    const unsigned char* p_data(readPGMValue(m_p_data + 2, aHeader.m_width));
+    p_data = readPGMValue(p_data, aHeader.m_height);
+    p_data = readPGMValue(p_data, aHeader.m_max_value);
+
+    if (!p_data || !aHeader.m_max_value || aHeader.m_max_value > 65535)
+    {
+        return (false);
+    }
+    aHeader.m_bytes_per_pixel = (aHeader.m_max_value < 256 ? 1 : 2);
+
+    // The pixels of a P5 file follow a single whitespace
+    if (aHeader.m_is_binary)
+    {
+        const std::size_t byte_count(std::size_t(aHeader.m_width) *
+                aHeader.m_height * aHeader.m_bytes_per_pixel);
+        if (std::size_t(m_p_data + m_size - p_data) < 1 + byte_count)
+        {
+            return (false);
+        }
+        ++p_data;
+    }
+
+    aHeader.m_p_pixels = p_data;
+    return (true);
+}
+
+
+//------------------------------------------------------------------------
+const unsigned char* MappedFile::readPGMValue(const unsigned char* apData,
+                                              unsigned int& aValue) const
+//------------------------------------------------------------------------
+{
+    if (!apData)
+    {
+        return (0);
+    }
+
+    const unsigned char* p_end(m_p_data + m_size);
+
+    // Skip the whitespaces and the comments
+    while (apData < p_end && (std::isspace(*apData) || *apData == '#'))
+    {
+        if (*apData == '#')
+        {
+            while (apData < p_end && *apData != '\n' && *apData != '\r')
+            {
+                ++apData;
+            }
+        }
+        else
+        {
+            ++apData;
+        }
+    }
+
+    // There is no number
+    if (apData == p_end || !std::isdigit(*apData))
+    {
+        return (0);
+    }
+
+    // Read the digits
+    aValue = 0;
+    while (apData < p_end && std::isdigit(*apData))
+    {
+        aValue = aValue * 10 + (*apData++ - '0');
+    }
+
+    return (apData);
+}
@@ -0,0 +1,1687 @@
+/**
+********************************************************************************
+*
+*   @file       RowKernels.cpp
+*
+*   @brief      Vectorised functions processing a row of pixels at once.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Define
+//******************************************************************************
+
+// x86 compilers that can generate AVX2 code for a single function
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ROW_KERNELS_X86
+#define ROW_KERNELS_TARGET_SSE  __attribute__((target("sse2")))
+#define ROW_KERNELS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define ROW_KERNELS_X86
+#define ROW_KERNELS_TARGET_SSE
+#define ROW_KERNELS_TARGET_AVX2
+#endif
+
+
+// Median of 9 values: 19 compare-exchanges, SORT(a, b) puts the min in a
+// and the max in b. The median ends up in p[4].
+#define MEDIAN_9_NETWORK(SORT, p)                                   \
+    SORT(p[1], p[2]); SORT(p[4], p[5]); SORT(p[7], p[8]);          \
+    SORT(p[0], p[1]); SORT(p[3], p[4]); SORT(p[6], p[7]);          \
+    SORT(p[1], p[2]); SORT(p[4], p[5]); SORT(p[7], p[8]);          \
+    SORT(p[0], p[3]); SORT(p[5], p[8]); SORT(p[4], p[7]);          \
+    SORT(p[3], p[6]); SORT(p[1], p[4]); SORT(p[2], p[5]);          \
+    SORT(p[4], p[7]); SORT(p[4], p[2]); SORT(p[6], p[4]);          \
+    SORT(p[4], p[2]);
+
+#define SORT_SCALAR(a, b) { const float t(std::min(a, b)); b = std::max(a, b); a = t; }
+#define SORT_SSE(a, b)    { const __m128 t(_mm_min_ps(a, b)); b = _mm_max_ps(a, b); a = t; }
+#define SORT_AVX2(a, b)   { const __m256 t(_mm256_min_ps(a, b)); b = _mm256_max_ps(a, b); a = t; }
+
+
+// Combine the integer pixels of apFirst and apSecond STEP by STEP: a and b
+// are the vectors of input pixels, OPERATION gives the vector of output pixels
+#define COMBINE_LOOP(VECTOR, LOAD, STORE, STEP, OPERATION)                    \
+    for (; i + STEP <= aCount; i += STEP)                                     \
+    {                                                                         \
+        const VECTOR a(LOAD(reinterpret_cast<const VECTOR*>(apFirst + i)));   \
+        const VECTOR b(LOAD(reinterpret_cast<const VECTOR*>(apSecond + i)));  \
+        STORE(reinterpret_cast<VECTOR*>(apOutput + i), OPERATION);            \
+    }
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#ifdef ROW_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include <algorithm> // Header file for min/max
+#include <cmath> // Header file for sqrt/fabs
+#include <cstdlib> // Header file for abs
+#include <limits> // Header file for numeric_limits
+
+#include "RowKernels.h"
+
+
+//******************************************************************************
+//  Global variables
+//******************************************************************************
+
+/// The instruction set in use
+static RowKernels::InstructionSet g_instruction_set(RowKernels::getSupportedInstructionSet());
+
+
+//******************************************************************************
+//  Constant
+//******************************************************************************
+
+// atan(a) ~ a (C1 + s (C3 + s (C5 + s (C7 + s C9)))) with s = a^2, for a in
+// [0, 1] (Abramowitz and Stegun 4.4.47, maximum error 1e-5 radian)
+static const float ATAN_C1(0.9998660f);
+static const float ATAN_C3(-0.3302995f);
+static const float ATAN_C5(0.1801410f);
+static const float ATAN_C7(-0.0851330f);
+static const float ATAN_C9(0.0208351f);
+static const float PI(3.14159265f);
+static const float HALF_PI(1.57079633f);
+
+// Weights (side, centre) smoothing the derivatives of PREWITT, SOBEL and SCHARR
+static const float g_smoothing_weight_set[3][2] = { { 1, 1 }, { 1, 2 }, { 3, 10 } };
+
+
+//******************************************************************************
+//  Scalar versions
+//******************************************************************************
+
+//---------------------------------------------------------------
+static void convolve_3x3_scalar(const float* apAbove,
+                                const float* apRow,
+                                const float* apBelow,
+                                float* apOutput,
+                                unsigned int aFirst,
+                                unsigned int aCount,
+                                const float* apKernel,
+                                float aDivisor)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const float* p_above(apAbove + i);
+        const float* p_row(apRow + i);
+        const float* p_below(apBelow + i);
+
+        float sum(0);
+        sum += p_above[-1] * apKernel[0];
+        sum += p_above[0]  * apKernel[1];
+        sum += p_above[1]  * apKernel[2];
+        sum += p_row[-1]   * apKernel[3];
+        sum += p_row[0]    * apKernel[4];
+        sum += p_row[1]    * apKernel[5];
+        sum += p_below[-1] * apKernel[6];
+        sum += p_below[0]  * apKernel[7];
+        sum += p_below[1]  * apKernel[8];
+        apOutput[i] = sum / aDivisor;
+    }
+}
+
+
+//---------------------------------------------------------------
+static void multiplyAdd_scalar(const float* apInput,
+                               float aWeight,
+                               float* apOutput,
+                               unsigned int aFirst,
+                               unsigned int aCount)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        apOutput[i] += apInput[i] * aWeight;
+    }
+}
+
+
+//---------------------------------------------------------------
+static void median_3x3_scalar(const float* apAbove,
+                              const float* apRow,
+                              const float* apBelow,
+                              float* apOutput,
+                              unsigned int aFirst,
+                              unsigned int aCount)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const float* p_above(apAbove + i);
+        const float* p_row(apRow + i);
+        const float* p_below(apBelow + i);
+
+        float p[9] = {
+            p_above[-1], p_above[0], p_above[1],
+            p_row[-1],   p_row[0],   p_row[1],
+            p_below[-1], p_below[0], p_below[1]
+        };
+
+        MEDIAN_9_NETWORK(SORT_SCALAR, p);
+        apOutput[i] = p[4];
+    }
+}
+
+
+//---------------------------------------------------------------
+static float getDirection_scalar(float aGx, float aGy)
+//---------------------------------------------------------------
+{
+    // Angle in the first octant
+    const float abs_gx(std::fabs(aGx));
+    const float abs_gy(std::fabs(aGy));
+    const float ratio(std::max(abs_gx, abs_gy) > 0 ?
+            std::min(abs_gx, abs_gy) / std::max(abs_gx, abs_gy) : 0);
+    const float square(ratio * ratio);
+
+    float angle(ATAN_C9 * square);
+    angle = angle + ATAN_C7;
+    angle = angle * square;
+    angle = angle + ATAN_C5;
+    angle = angle * square;
+    angle = angle + ATAN_C3;
+    angle = angle * square;
+    angle = angle + ATAN_C1;
+    angle = angle * ratio;
+
+    // Back to the right quadrant
+    if (abs_gy > abs_gx)
+    {
+        angle = HALF_PI - angle;
+    }
+
+    if (aGx < 0)
+    {
+        angle = PI - angle;
+    }
+
+    if (aGy < 0)
+    {
+        angle = -angle;
+    }
+
+    return (angle);
+}
+
+
+//---------------------------------------------------------------
+static void gradient_3x3_scalar(const float* apAbove,
+                                const float* apRow,
+                                const float* apBelow,
+                                const RowKernels::GradientOutput* apOutputSet,
+                                unsigned int anOutputCount,
+                                unsigned int anOffset,
+                                unsigned int aFirst,
+                                unsigned int aCount,
+                                bool anL2NormFlag)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const float* p_above(apAbove + i);
+        const float* p_row(apRow + i);
+        const float* p_below(apBelow + i);
+
+        // Horizontal derivative of each row, vertical derivative of each
+        // column: shared by every operator
+        const float dx_above(p_above[1] - p_above[-1]);
+        const float dx_row(p_row[1] - p_row[-1]);
+        const float dx_below(p_below[1] - p_below[-1]);
+        const float dy_left(p_below[-1] - p_above[-1]);
+        const float dy_centre(p_below[0] - p_above[0]);
+        const float dy_right(p_below[1] - p_above[1]);
+
+        for (unsigned int k(0); k < anOutputCount; ++k)
+        {
+            const RowKernels::GradientOutput& output(apOutputSet[k]);
+
+            float gx, gy;
+            if (output.m_operator == RowKernels::ROBERTS)
+            {
+                // Differences along the two diagonals
+                gx = p_below[1] - p_row[0];
+                gy = p_below[0] - p_row[1];
+            }
+            else
+            {
+                // Derivatives smoothed across their direction
+                const float side(g_smoothing_weight_set[output.m_operator][0]);
+                const float centre(g_smoothing_weight_set[output.m_operator][1]);
+
+                gx = side * dx_above;
+                gx = gx + centre * dx_row;
+                gx = gx + side * dx_below;
+
+                gy = side * dy_left;
+                gy = gy + centre * dy_centre;
+                gy = gy + side * dy_right;
+            }
+
+            if (anL2NormFlag)
+            {
+                output.m_p_magnitude[anOffset + i] = std::sqrt(gx * gx + gy * gy);
+            }
+            else
+            {
+                output.m_p_magnitude[anOffset + i] = std::fabs(gx) + std::fabs(gy);
+            }
+
+            if (output.m_p_direction)
+            {
+                // The diagonals are rotated back to the axes of the image
+                if (output.m_operator == RowKernels::ROBERTS)
+                {
+                    output.m_p_direction[anOffset + i] = getDirection_scalar(gx - gy, gx + gy);
+                }
+                else
+                {
+                    output.m_p_direction[anOffset + i] = getDirection_scalar(gx, gy);
+                }
+            }
+        }
+    }
+}
+
+
+//---------------------------------------------------------------
+static void getStatistics_scalar(const float* apRow,
+                                 unsigned int aFirst,
+                                 unsigned int aCount,
+                                 float aShift,
+                                 RowKernels::RowStatistics& aStatistics)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const double difference(double(apRow[i]) - aShift);
+        aStatistics.m_min_value = std::min(aStatistics.m_min_value, apRow[i]);
+        aStatistics.m_max_value = std::max(aStatistics.m_max_value, apRow[i]);
+        aStatistics.m_sum += difference;
+        aStatistics.m_square_sum += difference * difference;
+    }
+}
+
+
+//---------------------------------------------------------------
+static void compare_scalar(const float* apFirst,
+                           const float* apSecond,
+                           unsigned int aFirst,
+                           unsigned int aCount,
+                           float aFirstShift,
+                           float aSecondShift,
+                           RowKernels::RowComparison& aComparison)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const double a(apFirst[i]);
+        const double b(apSecond[i]);
+        const double difference(a - b);
+        const double x(a - aFirstShift);
+        const double y(b - aSecondShift);
+
+        aComparison.m_absolute_sum += std::fabs(difference);
+        aComparison.m_square_sum += difference * difference;
+        aComparison.m_first_sum += x;
+        aComparison.m_second_sum += y;
+        aComparison.m_first_square_sum += x * x;
+        aComparison.m_second_square_sum += y * y;
+        aComparison.m_product_sum += x * y;
+    }
+}
+
+
+//---------------------------------------------------------------
+template<typename T>
+static void combine_scalar(const T* apFirst,
+                           const T* apSecond,
+                           T* apOutput,
+                           unsigned int aFirst,
+                           unsigned int aCount,
+                           RowKernels::IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    const int max_value(std::numeric_limits<T>::max());
+
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        const int a(apFirst[i]);
+        const int b(apSecond[i]);
+
+        int result(0);
+        switch (anOperation)
+        {
+        case RowKernels::ADD_SATURATE:
+            result = std::min(a + b, max_value);
+            break;
+
+        case RowKernels::SUBTRACT_SATURATE:
+            result = std::max(a - b, 0);
+            break;
+
+        case RowKernels::ABSOLUTE_DIFFERENCE:
+            result = std::abs(a - b);
+            break;
+        }
+
+        apOutput[i] = T(result);
+    }
+}
+
+
+//---------------------------------------------------------------
+template<typename T>
+static void convert_scalar(const float* apInput,
+                           T* apOutput,
+                           unsigned int aFirst,
+                           unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const float max_value(std::numeric_limits<T>::max());
+
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        // Same operations as the SSE version (NaN gives 0)
+        const float value(std::min(max_value, std::max(0.0f, apInput[i])));
+        apOutput[i] = T(value + 0.5f);
+    }
+}
+
+
+//---------------------------------------------------------------
+static void convert_scalar(const std::uint8_t* apInput,
+                           float* apOutput,
+                           unsigned int aFirst,
+                           unsigned int aCount)
+//---------------------------------------------------------------
+{
+    for (unsigned int i(aFirst); i < aCount; ++i)
+    {
+        apOutput[i] = apInput[i];
+    }
+}
+
+#ifdef ROW_KERNELS_X86
+//******************************************************************************
+//  SSE versions (4 pixels at once)
+//******************************************************************************
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int convolve_3x3_sse(const float* apAbove,
+                                     const float* apRow,
+                                     const float* apBelow,
+                                     float* apOutput,
+                                     unsigned int aCount,
+                                     const float* apKernel,
+                                     float aDivisor)
+//---------------------------------------------------------------
+{
+    const __m128 k0(_mm_set1_ps(apKernel[0])), k1(_mm_set1_ps(apKernel[1])), k2(_mm_set1_ps(apKernel[2]));
+    const __m128 k3(_mm_set1_ps(apKernel[3])), k4(_mm_set1_ps(apKernel[4])), k5(_mm_set1_ps(apKernel[5]));
+    const __m128 k6(_mm_set1_ps(apKernel[6])), k7(_mm_set1_ps(apKernel[7])), k8(_mm_set1_ps(apKernel[8]));
+    const __m128 divisor(_mm_set1_ps(aDivisor));
+
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        // Same order of operations as the scalar version
+        __m128 sum(_mm_mul_ps(_mm_loadu_ps(apAbove + i - 1), k0));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apAbove + i),     k1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apAbove + i + 1), k2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apRow + i - 1),   k3));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apRow + i),       k4));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apRow + i + 1),   k5));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apBelow + i - 1), k6));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apBelow + i),     k7));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(apBelow + i + 1), k8));
+        _mm_storeu_ps(apOutput + i, _mm_div_ps(sum, divisor));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int multiplyAdd_sse(const float* apInput,
+                                    float aWeight,
+                                    float* apOutput,
+                                    unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const __m128 weight(_mm_set1_ps(aWeight));
+
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        __m128 product(_mm_mul_ps(_mm_loadu_ps(apInput + i), weight));
+        _mm_storeu_ps(apOutput + i, _mm_add_ps(_mm_loadu_ps(apOutput + i), product));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int median_3x3_sse(const float* apAbove,
+                                   const float* apRow,
+                                   const float* apBelow,
+                                   float* apOutput,
+                                   unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        // The neighbourhoods of 4 adjacent pixels
+        __m128 p[9] = {
+            _mm_loadu_ps(apAbove + i - 1), _mm_loadu_ps(apAbove + i), _mm_loadu_ps(apAbove + i + 1),
+            _mm_loadu_ps(apRow + i - 1),   _mm_loadu_ps(apRow + i),   _mm_loadu_ps(apRow + i + 1),
+            _mm_loadu_ps(apBelow + i - 1), _mm_loadu_ps(apBelow + i), _mm_loadu_ps(apBelow + i + 1)
+        };
+
+        MEDIAN_9_NETWORK(SORT_SSE, p);
+        _mm_storeu_ps(apOutput + i, p[4]);
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static __m128 getDirection_sse(__m128 aGx, __m128 aGy)
+//---------------------------------------------------------------
+{
+    const __m128 sign_mask(_mm_set1_ps(-0.0f));
+    const __m128 zero(_mm_setzero_ps());
+
+    // Angle in the first octant (same operations as the scalar version)
+    const __m128 abs_gx(_mm_andnot_ps(sign_mask, aGx));
+    const __m128 abs_gy(_mm_andnot_ps(sign_mask, aGy));
+    const __m128 maximum(_mm_max_ps(abs_gx, abs_gy));
+    const __m128 ratio(_mm_and_ps(_mm_cmpgt_ps(maximum, zero),
+            _mm_div_ps(_mm_min_ps(abs_gx, abs_gy), maximum)));
+    const __m128 square(_mm_mul_ps(ratio, ratio));
+
+    __m128 angle(_mm_mul_ps(_mm_set1_ps(ATAN_C9), square));
+    angle = _mm_add_ps(angle, _mm_set1_ps(ATAN_C7));
+    angle = _mm_mul_ps(angle, square);
+    angle = _mm_add_ps(angle, _mm_set1_ps(ATAN_C5));
+    angle = _mm_mul_ps(angle, square);
+    angle = _mm_add_ps(angle, _mm_set1_ps(ATAN_C3));
+    angle = _mm_mul_ps(angle, square);
+    angle = _mm_add_ps(angle, _mm_set1_ps(ATAN_C1));
+    angle = _mm_mul_ps(angle, ratio);
+
+    // Back to the right quadrant (branchless selections)
+    __m128 mask(_mm_cmpgt_ps(abs_gy, abs_gx));
+    angle = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(HALF_PI), angle)), _mm_andnot_ps(mask, angle));
+
+    mask = _mm_cmplt_ps(aGx, zero);
+    angle = _mm_or_ps(_mm_and_ps(mask, _mm_sub_ps(_mm_set1_ps(PI), angle)), _mm_andnot_ps(mask, angle));
+
+    mask = _mm_cmplt_ps(aGy, zero);
+    return (_mm_xor_ps(angle, _mm_and_ps(mask, sign_mask)));
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int gradient_3x3_sse(const float* apAbove,
+                                     const float* apRow,
+                                     const float* apBelow,
+                                     const RowKernels::GradientOutput* apOutputSet,
+                                     unsigned int anOutputCount,
+                                     unsigned int anOffset,
+                                     unsigned int aCount,
+                                     bool anL2NormFlag)
+//---------------------------------------------------------------
+{
+    const __m128 sign_mask(_mm_set1_ps(-0.0f));
+
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        // The neighbourhoods of 4 adjacent pixels, loaded once
+        const __m128 above_left(_mm_loadu_ps(apAbove + i - 1));
+        const __m128 above_centre(_mm_loadu_ps(apAbove + i));
+        const __m128 above_right(_mm_loadu_ps(apAbove + i + 1));
+        const __m128 row_left(_mm_loadu_ps(apRow + i - 1));
+        const __m128 row_centre(_mm_loadu_ps(apRow + i));
+        const __m128 row_right(_mm_loadu_ps(apRow + i + 1));
+        const __m128 below_left(_mm_loadu_ps(apBelow + i - 1));
+        const __m128 below_centre(_mm_loadu_ps(apBelow + i));
+        const __m128 below_right(_mm_loadu_ps(apBelow + i + 1));
+
+        // Derivatives shared by every operator
+        const __m128 dx_above(_mm_sub_ps(above_right, above_left));
+        const __m128 dx_row(_mm_sub_ps(row_right, row_left));
+        const __m128 dx_below(_mm_sub_ps(below_right, below_left));
+        const __m128 dy_left(_mm_sub_ps(below_left, above_left));
+        const __m128 dy_centre(_mm_sub_ps(below_centre, above_centre));
+        const __m128 dy_right(_mm_sub_ps(below_right, above_right));
+
+        for (unsigned int k(0); k < anOutputCount; ++k)
+        {
+            const RowKernels::GradientOutput& output(apOutputSet[k]);
+
+            // Same order of operations as the scalar version
+            __m128 gx, gy;
+            if (output.m_operator == RowKernels::ROBERTS)
+            {
+                gx = _mm_sub_ps(below_right, row_centre);
+                gy = _mm_sub_ps(below_centre, row_right);
+            }
+            else
+            {
+                const __m128 side(_mm_set1_ps(g_smoothing_weight_set[output.m_operator][0]));
+                const __m128 centre(_mm_set1_ps(g_smoothing_weight_set[output.m_operator][1]));
+
+                gx = _mm_mul_ps(side, dx_above);
+                gx = _mm_add_ps(gx, _mm_mul_ps(centre, dx_row));
+                gx = _mm_add_ps(gx, _mm_mul_ps(side, dx_below));
+
+                gy = _mm_mul_ps(side, dy_left);
+                gy = _mm_add_ps(gy, _mm_mul_ps(centre, dy_centre));
+                gy = _mm_add_ps(gy, _mm_mul_ps(side, dy_right));
+            }
+
+            if (anL2NormFlag)
+            {
+                _mm_storeu_ps(output.m_p_magnitude + anOffset + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy))));
+            }
+            else
+            {
+                _mm_storeu_ps(output.m_p_magnitude + anOffset + i, _mm_add_ps(_mm_andnot_ps(sign_mask, gx), _mm_andnot_ps(sign_mask, gy)));
+            }
+
+            if (output.m_p_direction)
+            {
+                if (output.m_operator == RowKernels::ROBERTS)
+                {
+                    _mm_storeu_ps(output.m_p_direction + anOffset + i, getDirection_sse(_mm_sub_ps(gx, gy), _mm_add_ps(gx, gy)));
+                }
+                else
+                {
+                    _mm_storeu_ps(output.m_p_direction + anOffset + i, getDirection_sse(gx, gy));
+                }
+            }
+        }
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int getStatistics_sse(const float* apRow,
+                                      unsigned int aCount,
+                                      float aShift,
+                                      RowKernels::RowStatistics& aStatistics)
+//---------------------------------------------------------------
+{
+    const __m128d shift(_mm_set1_pd(aShift));
+    __m128 min_value(_mm_set1_ps(aStatistics.m_min_value));
+    __m128 max_value(_mm_set1_ps(aStatistics.m_max_value));
+    __m128d sum(_mm_setzero_pd()), square_sum(_mm_setzero_pd());
+
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        const __m128 value(_mm_loadu_ps(apRow + i));
+        min_value = _mm_min_ps(min_value, value);
+        max_value = _mm_max_ps(max_value, value);
+
+        // Two pixels per double vector
+        const __m128d low(_mm_sub_pd(_mm_cvtps_pd(value), shift));
+        const __m128d high(_mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(value, value)), shift));
+        sum = _mm_add_pd(sum, _mm_add_pd(low, high));
+        square_sum = _mm_add_pd(square_sum, _mm_add_pd(_mm_mul_pd(low, low), _mm_mul_pd(high, high)));
+    }
+
+    // Reduce the lanes
+    float p_min_set[4], p_max_set[4];
+    double p_sum_set[2], p_square_sum_set[2];
+    _mm_storeu_ps(p_min_set, min_value);
+    _mm_storeu_ps(p_max_set, max_value);
+    _mm_storeu_pd(p_sum_set, sum);
+    _mm_storeu_pd(p_square_sum_set, square_sum);
+    for (unsigned int k(0); k < 4; ++k)
+    {
+        aStatistics.m_min_value = std::min(aStatistics.m_min_value, p_min_set[k]);
+        aStatistics.m_max_value = std::max(aStatistics.m_max_value, p_max_set[k]);
+    }
+    aStatistics.m_sum += p_sum_set[0] + p_sum_set[1];
+    aStatistics.m_square_sum += p_square_sum_set[0] + p_square_sum_set[1];
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static double getSum_sse(__m128d aVector)
+//---------------------------------------------------------------
+{
+    double p_lane_set[2];
+    _mm_storeu_pd(p_lane_set, aVector);
+    return (p_lane_set[0] + p_lane_set[1]);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int compare_sse(const float* apFirst,
+                                const float* apSecond,
+                                unsigned int aCount,
+                                float aFirstShift,
+                                float aSecondShift,
+                                RowKernels::RowComparison& aComparison)
+//---------------------------------------------------------------
+{
+    const __m128d first_shift(_mm_set1_pd(aFirstShift));
+    const __m128d second_shift(_mm_set1_pd(aSecondShift));
+    const __m128d sign(_mm_set1_pd(-0.0));
+    __m128d absolute_sum(_mm_setzero_pd()), square_sum(_mm_setzero_pd());
+    __m128d first_sum(_mm_setzero_pd()), second_sum(_mm_setzero_pd());
+    __m128d first_square_sum(_mm_setzero_pd()), second_square_sum(_mm_setzero_pd());
+    __m128d product_sum(_mm_setzero_pd());
+
+    unsigned int i(0);
+    for (; i + 2 <= aCount; i += 2)
+    {
+        // Two pixels of each row per double vector
+        const __m128d a(_mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(apFirst + i)))));
+        const __m128d b(_mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(apSecond + i)))));
+        const __m128d difference(_mm_sub_pd(a, b));
+        const __m128d x(_mm_sub_pd(a, first_shift));
+        const __m128d y(_mm_sub_pd(b, second_shift));
+
+        absolute_sum = _mm_add_pd(absolute_sum, _mm_andnot_pd(sign, difference));
+        square_sum = _mm_add_pd(square_sum, _mm_mul_pd(difference, difference));
+        first_sum = _mm_add_pd(first_sum, x);
+        second_sum = _mm_add_pd(second_sum, y);
+        first_square_sum = _mm_add_pd(first_square_sum, _mm_mul_pd(x, x));
+        second_square_sum = _mm_add_pd(second_square_sum, _mm_mul_pd(y, y));
+        product_sum = _mm_add_pd(product_sum, _mm_mul_pd(x, y));
+    }
+
+    // Reduce the lanes
+    aComparison.m_absolute_sum += getSum_sse(absolute_sum);
+    aComparison.m_square_sum += getSum_sse(square_sum);
+    aComparison.m_first_sum += getSum_sse(first_sum);
+    aComparison.m_second_sum += getSum_sse(second_sum);
+    aComparison.m_first_square_sum += getSum_sse(first_square_sum);
+    aComparison.m_second_square_sum += getSum_sse(second_square_sum);
+    aComparison.m_product_sum += getSum_sse(product_sum);
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int combine_sse(const std::uint8_t* apFirst,
+                                const std::uint8_t* apSecond,
+                                std::uint8_t* apOutput,
+                                unsigned int aCount,
+                                RowKernels::IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    switch (anOperation)
+    {
+    case RowKernels::ADD_SATURATE:
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 16, _mm_adds_epu8(a, b));
+        break;
+
+    case RowKernels::SUBTRACT_SATURATE:
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 16, _mm_subs_epu8(a, b));
+        break;
+
+    case RowKernels::ABSOLUTE_DIFFERENCE:
+        // One of the two saturated differences is 0
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 16,
+                _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a)));
+        break;
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int combine_sse(const std::uint16_t* apFirst,
+                                const std::uint16_t* apSecond,
+                                std::uint16_t* apOutput,
+                                unsigned int aCount,
+                                RowKernels::IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    switch (anOperation)
+    {
+    case RowKernels::ADD_SATURATE:
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 8, _mm_adds_epu16(a, b));
+        break;
+
+    case RowKernels::SUBTRACT_SATURATE:
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 8, _mm_subs_epu16(a, b));
+        break;
+
+    case RowKernels::ABSOLUTE_DIFFERENCE:
+        COMBINE_LOOP(__m128i, _mm_loadu_si128, _mm_storeu_si128, 8,
+                _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a)));
+        break;
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static __m128i convertToInteger_sse(const float* apInput, __m128 aMaxValue)
+//---------------------------------------------------------------
+{
+    // max returns its second operand for NaN
+    const __m128 value(_mm_min_ps(aMaxValue, _mm_max_ps(_mm_loadu_ps(apInput), _mm_setzero_ps())));
+    return (_mm_cvttps_epi32(_mm_add_ps(value, _mm_set1_ps(0.5f))));
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int convert_sse(const float* apInput,
+                                std::uint8_t* apOutput,
+                                unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const __m128 max_value(_mm_set1_ps(255.0f));
+
+    unsigned int i(0);
+    for (; i + 16 <= aCount; i += 16)
+    {
+        // The values are in [0, 255]: the signed saturations do nothing
+        const __m128i low(_mm_packs_epi32(convertToInteger_sse(apInput + i, max_value),
+                convertToInteger_sse(apInput + i + 4, max_value)));
+        const __m128i high(_mm_packs_epi32(convertToInteger_sse(apInput + i + 8, max_value),
+                convertToInteger_sse(apInput + i + 12, max_value)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(apOutput + i), _mm_packus_epi16(low, high));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int convert_sse(const float* apInput,
+                                std::uint16_t* apOutput,
+                                unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const __m128 max_value(_mm_set1_ps(65535.0f));
+    const __m128i offset(_mm_set1_epi32(32768));
+    const __m128i sign(_mm_set1_epi16(-32768));
+
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        // SSE2 only packs to signed 16 bits: shift [0, 65535] to
+        // [-32768, 32767], pack, then flip the sign bit back
+        const __m128i low(_mm_sub_epi32(convertToInteger_sse(apInput + i, max_value), offset));
+        const __m128i high(_mm_sub_epi32(convertToInteger_sse(apInput + i + 4, max_value), offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(apOutput + i), _mm_xor_si128(_mm_packs_epi32(low, high), sign));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_SSE
+static unsigned int convert_sse(const std::uint8_t* apInput,
+                                float* apOutput,
+                                unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const __m128i zero(_mm_setzero_si128());
+
+    unsigned int i(0);
+    for (; i + 16 <= aCount; i += 16)
+    {
+        // Widen to 16 bits, then to 32 bits
+        const __m128i bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(apInput + i)));
+        const __m128i low(_mm_unpacklo_epi8(bytes, zero));
+        const __m128i high(_mm_unpackhi_epi8(bytes, zero));
+        _mm_storeu_ps(apOutput + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_ps(apOutput + i + 4,  _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_ps(apOutput + i + 8,  _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_ps(apOutput + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//******************************************************************************
+//  AVX2 versions (8 pixels at once)
+//******************************************************************************
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int convolve_3x3_avx2(const float* apAbove,
+                                      const float* apRow,
+                                      const float* apBelow,
+                                      float* apOutput,
+                                      unsigned int aCount,
+                                      const float* apKernel,
+                                      float aDivisor)
+//---------------------------------------------------------------
+{
+    const __m256 k0(_mm256_set1_ps(apKernel[0])), k1(_mm256_set1_ps(apKernel[1])), k2(_mm256_set1_ps(apKernel[2]));
+    const __m256 k3(_mm256_set1_ps(apKernel[3])), k4(_mm256_set1_ps(apKernel[4])), k5(_mm256_set1_ps(apKernel[5]));
+    const __m256 k6(_mm256_set1_ps(apKernel[6])), k7(_mm256_set1_ps(apKernel[7])), k8(_mm256_set1_ps(apKernel[8]));
+    const __m256 divisor(_mm256_set1_ps(aDivisor));
+
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        // Same order of operations as the scalar version (no FMA)
+        __m256 sum(_mm256_mul_ps(_mm256_loadu_ps(apAbove + i - 1), k0));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apAbove + i),     k1));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apAbove + i + 1), k2));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apRow + i - 1),   k3));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apRow + i),       k4));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apRow + i + 1),   k5));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apBelow + i - 1), k6));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apBelow + i),     k7));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(apBelow + i + 1), k8));
+        _mm256_storeu_ps(apOutput + i, _mm256_div_ps(sum, divisor));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int multiplyAdd_avx2(const float* apInput,
+                                     float aWeight,
+                                     float* apOutput,
+                                     unsigned int aCount)
+//---------------------------------------------------------------
+{
+    const __m256 weight(_mm256_set1_ps(aWeight));
+
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        __m256 product(_mm256_mul_ps(_mm256_loadu_ps(apInput + i), weight));
+        _mm256_storeu_ps(apOutput + i, _mm256_add_ps(_mm256_loadu_ps(apOutput + i), product));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int median_3x3_avx2(const float* apAbove,
+                                    const float* apRow,
+                                    const float* apBelow,
+                                    float* apOutput,
+                                    unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        // The neighbourhoods of 8 adjacent pixels
+        __m256 p[9] = {
+            _mm256_loadu_ps(apAbove + i - 1), _mm256_loadu_ps(apAbove + i), _mm256_loadu_ps(apAbove + i + 1),
+            _mm256_loadu_ps(apRow + i - 1),   _mm256_loadu_ps(apRow + i),   _mm256_loadu_ps(apRow + i + 1),
+            _mm256_loadu_ps(apBelow + i - 1), _mm256_loadu_ps(apBelow + i), _mm256_loadu_ps(apBelow + i + 1)
+        };
+
+        MEDIAN_9_NETWORK(SORT_AVX2, p);
+        _mm256_storeu_ps(apOutput + i, p[4]);
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static __m256 getDirection_avx2(__m256 aGx, __m256 aGy)
+//---------------------------------------------------------------
+{
+    const __m256 sign_mask(_mm256_set1_ps(-0.0f));
+    const __m256 zero(_mm256_setzero_ps());
+
+    // Angle in the first octant (same operations as the scalar version)
+    const __m256 abs_gx(_mm256_andnot_ps(sign_mask, aGx));
+    const __m256 abs_gy(_mm256_andnot_ps(sign_mask, aGy));
+    const __m256 maximum(_mm256_max_ps(abs_gx, abs_gy));
+    const __m256 ratio(_mm256_and_ps(_mm256_cmp_ps(maximum, zero, _CMP_GT_OQ),
+            _mm256_div_ps(_mm256_min_ps(abs_gx, abs_gy), maximum)));
+    const __m256 square(_mm256_mul_ps(ratio, ratio));
+
+    __m256 angle(_mm256_mul_ps(_mm256_set1_ps(ATAN_C9), square));
+    angle = _mm256_add_ps(angle, _mm256_set1_ps(ATAN_C7));
+    angle = _mm256_mul_ps(angle, square);
+    angle = _mm256_add_ps(angle, _mm256_set1_ps(ATAN_C5));
+    angle = _mm256_mul_ps(angle, square);
+    angle = _mm256_add_ps(angle, _mm256_set1_ps(ATAN_C3));
+    angle = _mm256_mul_ps(angle, square);
+    angle = _mm256_add_ps(angle, _mm256_set1_ps(ATAN_C1));
+    angle = _mm256_mul_ps(angle, ratio);
+
+    // Back to the right quadrant (branchless selections)
+    angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), angle),
+            _mm256_cmp_ps(abs_gy, abs_gx, _CMP_GT_OQ));
+    angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(PI), angle),
+            _mm256_cmp_ps(aGx, zero, _CMP_LT_OQ));
+
+    return (_mm256_xor_ps(angle, _mm256_and_ps(_mm256_cmp_ps(aGy, zero, _CMP_LT_OQ), sign_mask)));
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int gradient_3x3_avx2(const float* apAbove,
+                                      const float* apRow,
+                                      const float* apBelow,
+                                      const RowKernels::GradientOutput* apOutputSet,
+                                      unsigned int anOutputCount,
+                                      unsigned int anOffset,
+                                      unsigned int aCount,
+                                      bool anL2NormFlag)
+//---------------------------------------------------------------
+{
+    const __m256 sign_mask(_mm256_set1_ps(-0.0f));
+
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        // The neighbourhoods of 8 adjacent pixels, loaded once
+        const __m256 above_left(_mm256_loadu_ps(apAbove + i - 1));
+        const __m256 above_centre(_mm256_loadu_ps(apAbove + i));
+        const __m256 above_right(_mm256_loadu_ps(apAbove + i + 1));
+        const __m256 row_left(_mm256_loadu_ps(apRow + i - 1));
+        const __m256 row_centre(_mm256_loadu_ps(apRow + i));
+        const __m256 row_right(_mm256_loadu_ps(apRow + i + 1));
+        const __m256 below_left(_mm256_loadu_ps(apBelow + i - 1));
+        const __m256 below_centre(_mm256_loadu_ps(apBelow + i));
+        const __m256 below_right(_mm256_loadu_ps(apBelow + i + 1));
+
+        // Derivatives shared by every operator
+        const __m256 dx_above(_mm256_sub_ps(above_right, above_left));
+        const __m256 dx_row(_mm256_sub_ps(row_right, row_left));
+        const __m256 dx_below(_mm256_sub_ps(below_right, below_left));
+        const __m256 dy_left(_mm256_sub_ps(below_left, above_left));
+        const __m256 dy_centre(_mm256_sub_ps(below_centre, above_centre));
+        const __m256 dy_right(_mm256_sub_ps(below_right, above_right));
+
+        for (unsigned int k(0); k < anOutputCount; ++k)
+        {
+            const RowKernels::GradientOutput& output(apOutputSet[k]);
+
+            // Same order of operations as the scalar version (no FMA)
+            __m256 gx, gy;
+            if (output.m_operator == RowKernels::ROBERTS)
+            {
+                gx = _mm256_sub_ps(below_right, row_centre);
+                gy = _mm256_sub_ps(below_centre, row_right);
+            }
+            else
+            {
+                const __m256 side(_mm256_set1_ps(g_smoothing_weight_set[output.m_operator][0]));
+                const __m256 centre(_mm256_set1_ps(g_smoothing_weight_set[output.m_operator][1]));
+
+                gx = _mm256_mul_ps(side, dx_above);
+                gx = _mm256_add_ps(gx, _mm256_mul_ps(centre, dx_row));
+                gx = _mm256_add_ps(gx, _mm256_mul_ps(side, dx_below));
+
+                gy = _mm256_mul_ps(side, dy_left);
+                gy = _mm256_add_ps(gy, _mm256_mul_ps(centre, dy_centre));
+                gy = _mm256_add_ps(gy, _mm256_mul_ps(side, dy_right));
+            }
+
+            if (anL2NormFlag)
+            {
+                _mm256_storeu_ps(output.m_p_magnitude + anOffset + i, _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy))));
+            }
+            else
+            {
+                _mm256_storeu_ps(output.m_p_magnitude + anOffset + i, _mm256_add_ps(_mm256_andnot_ps(sign_mask, gx), _mm256_andnot_ps(sign_mask, gy)));
+            }
+
+            if (output.m_p_direction)
+            {
+                if (output.m_operator == RowKernels::ROBERTS)
+                {
+                    _mm256_storeu_ps(output.m_p_direction + anOffset + i, getDirection_avx2(_mm256_sub_ps(gx, gy), _mm256_add_ps(gx, gy)));
+                }
+                else
+                {
+                    _mm256_storeu_ps(output.m_p_direction + anOffset + i, getDirection_avx2(gx, gy));
+                }
+            }
+        }
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int getStatistics_avx2(const float* apRow,
+                                       unsigned int aCount,
+                                       float aShift,
+                                       RowKernels::RowStatistics& aStatistics)
+//---------------------------------------------------------------
+{
+    const __m256d shift(_mm256_set1_pd(aShift));
+    __m256 min_value(_mm256_set1_ps(aStatistics.m_min_value));
+    __m256 max_value(_mm256_set1_ps(aStatistics.m_max_value));
+    __m256d sum(_mm256_setzero_pd()), square_sum(_mm256_setzero_pd());
+
+    unsigned int i(0);
+    for (; i + 8 <= aCount; i += 8)
+    {
+        const __m256 value(_mm256_loadu_ps(apRow + i));
+        min_value = _mm256_min_ps(min_value, value);
+        max_value = _mm256_max_ps(max_value, value);
+
+        // Four pixels per double vector
+        const __m256d low(_mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(value)), shift));
+        const __m256d high(_mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)), shift));
+        sum = _mm256_add_pd(sum, _mm256_add_pd(low, high));
+        square_sum = _mm256_add_pd(square_sum, _mm256_add_pd(_mm256_mul_pd(low, low), _mm256_mul_pd(high, high)));
+    }
+
+    // Reduce the lanes
+    float p_min_set[8], p_max_set[8];
+    double p_sum_set[4], p_square_sum_set[4];
+    _mm256_storeu_ps(p_min_set, min_value);
+    _mm256_storeu_ps(p_max_set, max_value);
+    _mm256_storeu_pd(p_sum_set, sum);
+    _mm256_storeu_pd(p_square_sum_set, square_sum);
+    for (unsigned int k(0); k < 8; ++k)
+    {
+        aStatistics.m_min_value = std::min(aStatistics.m_min_value, p_min_set[k]);
+        aStatistics.m_max_value = std::max(aStatistics.m_max_value, p_max_set[k]);
+    }
+    aStatistics.m_sum += (p_sum_set[0] + p_sum_set[1]) + (p_sum_set[2] + p_sum_set[3]);
+    aStatistics.m_square_sum += (p_square_sum_set[0] + p_square_sum_set[1]) + (p_square_sum_set[2] + p_square_sum_set[3]);
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static double getSum_avx2(__m256d aVector)
+//---------------------------------------------------------------
+{
+    double p_lane_set[4];
+    _mm256_storeu_pd(p_lane_set, aVector);
+    return ((p_lane_set[0] + p_lane_set[1]) + (p_lane_set[2] + p_lane_set[3]));
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int compare_avx2(const float* apFirst,
+                                 const float* apSecond,
+                                 unsigned int aCount,
+                                 float aFirstShift,
+                                 float aSecondShift,
+                                 RowKernels::RowComparison& aComparison)
+//---------------------------------------------------------------
+{
+    const __m256d first_shift(_mm256_set1_pd(aFirstShift));
+    const __m256d second_shift(_mm256_set1_pd(aSecondShift));
+    const __m256d sign(_mm256_set1_pd(-0.0));
+    __m256d absolute_sum(_mm256_setzero_pd()), square_sum(_mm256_setzero_pd());
+    __m256d first_sum(_mm256_setzero_pd()), second_sum(_mm256_setzero_pd());
+    __m256d first_square_sum(_mm256_setzero_pd()), second_square_sum(_mm256_setzero_pd());
+    __m256d product_sum(_mm256_setzero_pd());
+
+    unsigned int i(0);
+    for (; i + 4 <= aCount; i += 4)
+    {
+        // Four pixels of each row per double vector
+        const __m256d a(_mm256_cvtps_pd(_mm_loadu_ps(apFirst + i)));
+        const __m256d b(_mm256_cvtps_pd(_mm_loadu_ps(apSecond + i)));
+        const __m256d difference(_mm256_sub_pd(a, b));
+        const __m256d x(_mm256_sub_pd(a, first_shift));
+        const __m256d y(_mm256_sub_pd(b, second_shift));
+
+        absolute_sum = _mm256_add_pd(absolute_sum, _mm256_andnot_pd(sign, difference));
+        square_sum = _mm256_add_pd(square_sum, _mm256_mul_pd(difference, difference));
+        first_sum = _mm256_add_pd(first_sum, x);
+        second_sum = _mm256_add_pd(second_sum, y);
+        first_square_sum = _mm256_add_pd(first_square_sum, _mm256_mul_pd(x, x));
+        second_square_sum = _mm256_add_pd(second_square_sum, _mm256_mul_pd(y, y));
+        product_sum = _mm256_add_pd(product_sum, _mm256_mul_pd(x, y));
+    }
+
+    // Reduce the lanes
+    aComparison.m_absolute_sum += getSum_avx2(absolute_sum);
+    aComparison.m_square_sum += getSum_avx2(square_sum);
+    aComparison.m_first_sum += getSum_avx2(first_sum);
+    aComparison.m_second_sum += getSum_avx2(second_sum);
+    aComparison.m_first_square_sum += getSum_avx2(first_square_sum);
+    aComparison.m_second_square_sum += getSum_avx2(second_square_sum);
+    aComparison.m_product_sum += getSum_avx2(product_sum);
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int combine_avx2(const std::uint8_t* apFirst,
+                                 const std::uint8_t* apSecond,
+                                 std::uint8_t* apOutput,
+                                 unsigned int aCount,
+                                 RowKernels::IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    switch (anOperation)
+    {
+    case RowKernels::ADD_SATURATE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 32, _mm256_adds_epu8(a, b));
+        break;
+
+    case RowKernels::SUBTRACT_SATURATE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 32, _mm256_subs_epu8(a, b));
+        break;
+
+    case RowKernels::ABSOLUTE_DIFFERENCE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 32,
+                _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a)));
+        break;
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int combine_avx2(const std::uint16_t* apFirst,
+                                 const std::uint16_t* apSecond,
+                                 std::uint16_t* apOutput,
+                                 unsigned int aCount,
+                                 RowKernels::IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    switch (anOperation)
+    {
+    case RowKernels::ADD_SATURATE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 16, _mm256_adds_epu16(a, b));
+        break;
+
+    case RowKernels::SUBTRACT_SATURATE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 16, _mm256_subs_epu16(a, b));
+        break;
+
+    case RowKernels::ABSOLUTE_DIFFERENCE:
+        COMBINE_LOOP(__m256i, _mm256_loadu_si256, _mm256_storeu_si256, 16,
+                _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a)));
+        break;
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+
+
+//---------------------------------------------------------------
+ROW_KERNELS_TARGET_AVX2
+static unsigned int convert_avx2(const std::uint8_t* apInput,
+                                 float* apOutput,
+                                 unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int i(0);
+    for (; i + 16 <= aCount; i += 16)
+    {
+        // 8 bytes are widened to 8 integers at once
+        const __m128i low(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(apInput + i)));
+        const __m128i high(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(apInput + i + 8)));
+        _mm256_storeu_ps(apOutput + i,     _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(low)));
+        _mm256_storeu_ps(apOutput + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(high)));
+    }
+
+    // Number of pixels processed
+    return (i);
+}
+#endif
+
+
+//******************************************************************************
+//  Dispatch
+//******************************************************************************
+
+//-----------------------------------------------------------------------
+RowKernels::InstructionSet RowKernels::getSupportedInstructionSet()
+//-----------------------------------------------------------------------
+{
+#if defined(ROW_KERNELS_X86) && defined(_MSC_VER)
+    int p_register_set[4];
+    __cpuid(p_register_set, 0);
+    const int max_leaf(p_register_set[0]);
+
+    __cpuid(p_register_set, 1);
+    const bool has_sse2((p_register_set[3] & (1 << 26)) != 0);
+    const bool has_osxsave((p_register_set[2] & (1 << 27)) != 0);
+    const bool has_avx((p_register_set[2] & (1 << 28)) != 0);
+
+    bool has_avx2(false);
+    if (max_leaf >= 7 && has_osxsave && has_avx)
+    {
+        // The OS saves the YMM registers
+        if ((_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(p_register_set, 7, 0);
+            has_avx2 = (p_register_set[1] & (1 << 5)) != 0;
+        }
+    }
+
+    if (has_avx2)
+    {
+        return (AVX2);
+    }
+    else if (has_sse2)
+    {
+        return (SSE);
+    }
+#elif defined(ROW_KERNELS_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return (AVX2);
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        return (SSE);
+    }
+#endif
+
+    return (SCALAR);
+}
+
+
+//-----------------------------------------------------------
+RowKernels::InstructionSet RowKernels::getInstructionSet()
+//-----------------------------------------------------------
+{
+    return (g_instruction_set);
+}
+
+
+//-------------------------------------------------------------------------
+void RowKernels::setInstructionSet(InstructionSet anInstructionSet)
+//-------------------------------------------------------------------------
+{
+    g_instruction_set = anInstructionSet;
+
+    // The CPU does not support it
+    if (g_instruction_set > getSupportedInstructionSet())
+    {
+        g_instruction_set = getSupportedInstructionSet();
+    }
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::convolve_3x3(const float* apAbove,
+                              const float* apRow,
+                              const float* apBelow,
+                              float* apOutput,
+                              unsigned int aCount,
+                              const float* apKernel,
+                              float aDivisor)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = convolve_3x3_avx2(apAbove, apRow, apBelow, apOutput, aCount, apKernel, aDivisor);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = convolve_3x3_sse(apAbove, apRow, apBelow, apOutput, aCount, apKernel, aDivisor);
+    }
+#endif
+
+    // The remaining pixels
+    convolve_3x3_scalar(apAbove, apRow, apBelow, apOutput, first, aCount, apKernel, aDivisor);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::median_3x3(const float* apAbove,
+                            const float* apRow,
+                            const float* apBelow,
+                            float* apOutput,
+                            unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = median_3x3_avx2(apAbove, apRow, apBelow, apOutput, aCount);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = median_3x3_sse(apAbove, apRow, apBelow, apOutput, aCount);
+    }
+#endif
+
+    // The remaining pixels
+    median_3x3_scalar(apAbove, apRow, apBelow, apOutput, first, aCount);
+}
+
+
+//-----------------------------------------------
+float RowKernels::getMedian9(float* apValues)
+//-----------------------------------------------
+{
+    MEDIAN_9_NETWORK(SORT_SCALAR, apValues);
+    return (apValues[4]);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::multiplyAdd(const float* apInput,
+                             float aWeight,
+                             float* apOutput,
+                             unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = multiplyAdd_avx2(apInput, aWeight, apOutput, aCount);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = multiplyAdd_sse(apInput, aWeight, apOutput, aCount);
+    }
+#endif
+
+    // The remaining pixels
+    multiplyAdd_scalar(apInput, aWeight, apOutput, first, aCount);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::gradient_3x3(const float* apAbove,
+                              const float* apRow,
+                              const float* apBelow,
+                              const GradientOutput* apOutputSet,
+                              unsigned int anOutputCount,
+                              unsigned int anOffset,
+                              unsigned int aCount,
+                              bool anL2NormFlag)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = gradient_3x3_avx2(apAbove, apRow, apBelow, apOutputSet, anOutputCount, anOffset, aCount, anL2NormFlag);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = gradient_3x3_sse(apAbove, apRow, apBelow, apOutputSet, anOutputCount, anOffset, aCount, anL2NormFlag);
+    }
+#endif
+
+    // The remaining pixels
+    gradient_3x3_scalar(apAbove, apRow, apBelow, apOutputSet, anOutputCount, anOffset, first, aCount, anL2NormFlag);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::getStatistics(const float* apRow,
+                               unsigned int aCount,
+                               float aShift,
+                               RowStatistics& aStatistics)
+//---------------------------------------------------------------
+{
+    aStatistics.m_min_value = apRow[0];
+    aStatistics.m_max_value = apRow[0];
+    aStatistics.m_sum = 0;
+    aStatistics.m_square_sum = 0;
+
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = getStatistics_avx2(apRow, aCount, aShift, aStatistics);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = getStatistics_sse(apRow, aCount, aShift, aStatistics);
+    }
+#endif
+
+    // The remaining pixels
+    getStatistics_scalar(apRow, first, aCount, aShift, aStatistics);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::compare(const float* apFirst,
+                         const float* apSecond,
+                         unsigned int aCount,
+                         float aFirstShift,
+                         float aSecondShift,
+                         RowComparison& aComparison)
+//---------------------------------------------------------------
+{
+    aComparison.m_absolute_sum = 0;
+    aComparison.m_square_sum = 0;
+    aComparison.m_first_sum = 0;
+    aComparison.m_second_sum = 0;
+    aComparison.m_first_square_sum = 0;
+    aComparison.m_second_square_sum = 0;
+    aComparison.m_product_sum = 0;
+
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = compare_avx2(apFirst, apSecond, aCount, aFirstShift, aSecondShift, aComparison);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = compare_sse(apFirst, apSecond, aCount, aFirstShift, aSecondShift, aComparison);
+    }
+#endif
+
+    // The remaining pixels
+    compare_scalar(apFirst, apSecond, first, aCount, aFirstShift, aSecondShift, aComparison);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::combine(const std::uint8_t* apFirst,
+                         const std::uint8_t* apSecond,
+                         std::uint8_t* apOutput,
+                         unsigned int aCount,
+                         IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = combine_avx2(apFirst, apSecond, apOutput, aCount, anOperation);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = combine_sse(apFirst, apSecond, apOutput, aCount, anOperation);
+    }
+#endif
+
+    // The remaining pixels
+    combine_scalar(apFirst, apSecond, apOutput, first, aCount, anOperation);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::combine(const std::uint16_t* apFirst,
+                         const std::uint16_t* apSecond,
+                         std::uint16_t* apOutput,
+                         unsigned int aCount,
+                         IntegerOperation anOperation)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = combine_avx2(apFirst, apSecond, apOutput, aCount, anOperation);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = combine_sse(apFirst, apSecond, apOutput, aCount, anOperation);
+    }
+#endif
+
+    // The remaining pixels
+    combine_scalar(apFirst, apSecond, apOutput, first, aCount, anOperation);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::convert(const float* apInput,
+                         std::uint8_t* apOutput,
+                         unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    // The packing instructions of AVX2 work within 128-bit lanes: the SSE
+    // version is used
+    if (g_instruction_set != SCALAR)
+    {
+        first = convert_sse(apInput, apOutput, aCount);
+    }
+#endif
+
+    // The remaining pixels
+    convert_scalar(apInput, apOutput, first, aCount);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::convert(const float* apInput,
+                         std::uint16_t* apOutput,
+                         unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    // The packing instructions of AVX2 work within 128-bit lanes: the SSE
+    // version is used
+    if (g_instruction_set != SCALAR)
+    {
+        first = convert_sse(apInput, apOutput, aCount);
+    }
+#endif
+
+    // The remaining pixels
+    convert_scalar(apInput, apOutput, first, aCount);
+}
+
+
+//---------------------------------------------------------------
+void RowKernels::convert(const std::uint8_t* apInput,
+                         float* apOutput,
+                         unsigned int aCount)
+//---------------------------------------------------------------
+{
+    unsigned int first(0);
+
+#ifdef ROW_KERNELS_X86
+    if (g_instruction_set == AVX2)
+    {
+        first = convert_avx2(apInput, apOutput, aCount);
+    }
+    else if (g_instruction_set == SSE)
+    {
+        first = convert_sse(apInput, apOutput, aCount);
+    }
+#endif
+
+    // The remaining pixels
+    convert_scalar(apInput, apOutput, first, aCount);
+}
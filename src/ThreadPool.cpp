@@ -0,0 +1,205 @@
+/**
+********************************************************************************
+*
+*   @file       ThreadPool.cpp
+*
+*   @brief      Class to run row bands of an image on worker threads.
+*
+*   @version    1.0
+*
+*   @date       16/10/2026
+*
+*   @author     agent
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//  Include
+//******************************************************************************
+#include <algorithm> // Header file for min/max
+
+#include "ThreadPool.h"
+
+
+//******************************************************************************
+//  Global variables
+//******************************************************************************
+
+/// The current thread is processing a band (nested ranges are run serially)
+static thread_local bool g_is_in_band(false);
+
+
+//----------------------------------------------------------
+ThreadPool::ThreadPool(unsigned int aNumberOfThreads):
+//----------------------------------------------------------
+        m_generation(0),
+        m_pending_count(0),
+        m_stop(false),
+        m_p_task(0),
+        m_first(0),
+        m_last(0),
+        m_band_count(0)
+//----------------------------------------------------------
+{
+    // Use every hardware thread
+    if (!aNumberOfThreads)
+    {
+        aNumberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // The caller processes the first band
+    for (unsigned int i(1); i < aNumberOfThreads; ++i)
+    {
+        m_thread_set.push_back(std::thread(&ThreadPool::run, this, i));
+    }
+}
+
+
+//----------------------
+ThreadPool::~ThreadPool()
+//----------------------
+{
+    // Ask the workers to exit
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start_condition.notify_all();
+
+    // Wait for them
+    for (unsigned int i(0); i < m_thread_set.size(); ++i)
+    {
+        m_thread_set[i].join();
+    }
+}
+
+
+//-------------------------------------------------
+unsigned int ThreadPool::getNumberOfThreads() const
+//-------------------------------------------------
+{
+    return (m_thread_set.size() + 1);
+}
+
+
+//-------------------------------------------------------------------
+void ThreadPool::parallelFor(unsigned int aFirst,
+                             unsigned int aLast,
+                             const Task& aTask)
+//-------------------------------------------------------------------
+{
+    // Nothing to do
+    if (aFirst >= aLast)
+    {
+        return;
+    }
+
+    unsigned int band_count(std::min(getNumberOfThreads(), aLast - aFirst));
+
+    // Single band, or called from a task: run in the current thread
+    if (band_count == 1 || g_is_in_band)
+    {
+        aTask(aFirst, aLast);
+        return;
+    }
+
+    // Only one range at a time
+    std::lock_guard<std::mutex> dispatch_lock(m_dispatch_mutex);
+
+    // Post the range
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_p_task        = &aTask;
+        m_first         = aFirst;
+        m_last          = aLast;
+        m_band_count    = band_count;
+        m_pending_count = m_thread_set.size();
+        m_error         = std::exception_ptr();
+        ++m_generation;
+    }
+    m_start_condition.notify_all();
+
+    // Process the first band
+    processBand(0);
+
+    // Wait for the workers
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this]{ return (!m_pending_count); });
+    m_p_task = 0;
+
+    // A task failed
+    if (m_error)
+    {
+        std::exception_ptr error(m_error);
+        m_error = std::exception_ptr();
+        std::rethrow_exception(error);
+    }
+}
+
+
+//--------------------------------------------
+void ThreadPool::run(unsigned int aThreadIndex)
+//--------------------------------------------
+{
+    unsigned long generation(0);
+
+    while (true)
+    {
+        // Wait for a new range
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_condition.wait(lock, [&]{ return (m_stop || m_generation != generation); });
+
+            if (m_stop)
+            {
+                return;
+            }
+
+            generation = m_generation;
+        }
+
+        // Process the band of this thread (if any)
+        if (aThreadIndex < m_band_count)
+        {
+            processBand(aThreadIndex);
+        }
+
+        // Tell the caller
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!--m_pending_count)
+            {
+                m_done_condition.notify_one();
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------
+void ThreadPool::processBand(unsigned int aThreadIndex)
+//----------------------------------------------------
+{
+    // Contiguous bands of (almost) equal size
+    unsigned long long size(m_last - m_first);
+    unsigned int first(m_first + (size * aThreadIndex) / m_band_count);
+    unsigned int last(m_first + (size * (aThreadIndex + 1)) / m_band_count);
+
+    g_is_in_band = true;
+    try
+    {
+        (*m_p_task)(first, last);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error)
+        {
+            m_error = std::current_exception();
+        }
+    }
+    g_is_in_band = false;
+}
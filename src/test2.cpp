@@ -23,9 +23,1431 @@
 //******************************************************************************
 #include <sstream>
 #include <iostream>
+#include <fstream>
 #include <exception>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "BufferPool.h"
 #include "Image.h"
+#include "MappedFile.h"
+#include "PixelImage.h"
+#include "RowKernels.h"
+
+
+//------------------------------------------------------------------------------
+/// Print the result of a check.
+/**
+* @param aName: the name of the check
+* @param aResult: true if the check succeeded
+* @param anErrorCode: set to 1 if the check failed
+*/
+//------------------------------------------------------------------------------
+static void printCheck(const std::string& aName, bool aResult, int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	std::cout << aName << ": " << (aResult ? "SUCCESS" : "FAILURE") << std::endl;
+	if (!aResult)
+	{
+		anErrorCode = 1;
+	}
+}
+
+
+//------------------------------------------------------------------------------
+/// Compare an image with a reference image saved by savePGM: the pixels are
+/// truncated and clamped to [0, 255] like in the file, then they may differ
+/// by one grey level (float rounding).
+/**
+* @param anImage: the image to check
+* @param aReference: the reference image
+* @return true if the images match
+*/
+//------------------------------------------------------------------------------
+static bool isCloseToReference(const Image& anImage, const Image& aReference)
+//------------------------------------------------------------------------------
+{
+	if (anImage.getWidth() != aReference.getWidth() ||
+		anImage.getHeight() != aReference.getHeight())
+	{
+		return (false);
+	}
+
+	for (unsigned int j(0); j < anImage.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < anImage.getWidth(); ++i)
+		{
+			const int value(std::max(0, std::min(255, int(anImage.getPixel(i, j)))));
+			if (std::abs(value - aReference.getPixel(i, j)) > 1)
+			{
+				return (false);
+			}
+		}
+	}
+
+	return (true);
+}
+
+
+//------------------------------------------------------------------------------
+/// Create an image of pseudo-random integer pixels in [0, 255] (always the
+/// same for a given seed).
+/**
+* @param aWidth: the number of pixels along the horizontal axis
+* @param aHeight: the number of pixels along the vertical axis
+* @param aSeed: the seed of the generator
+* @return the image
+*/
+//------------------------------------------------------------------------------
+static Image createTestImage(unsigned int aWidth, unsigned int aHeight, unsigned int aSeed)
+//------------------------------------------------------------------------------
+{
+	Image image(aWidth, aHeight);
+
+	unsigned int state(aSeed);
+	for (unsigned int j(0); j < aHeight; ++j)
+	{
+		for (unsigned int i(0); i < aWidth; ++i)
+		{
+			state = state * 1664525u + 1013904223u;
+			image.setPixel(i, j, float(state >> 24));
+		}
+	}
+
+	return (image);
+}
+
+
+//------------------------------------------------------------------------------
+/// Largest absolute difference between the pixels of two images.
+/**
+* @param anImage1: the first image
+* @param anImage2: the second image
+* @return the difference (infinite if the sizes differ)
+*/
+//------------------------------------------------------------------------------
+static double getMaxDifference(const ImageView& anImage1, const ImageView& anImage2)
+//------------------------------------------------------------------------------
+{
+	if (anImage1.getWidth() != anImage2.getWidth() ||
+		anImage1.getHeight() != anImage2.getHeight())
+	{
+		return (std::numeric_limits<double>::infinity());
+	}
+
+	double difference(0);
+	for (unsigned int j(0); j < anImage1.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < anImage1.getWidth(); ++i)
+		{
+			difference = std::max(difference,
+				std::abs(double(anImage1.getPixel(i, j)) - anImage2.getPixel(i, j)));
+		}
+	}
+
+	return (difference);
+}
+
+
+//------------------------------------------------------------------------------
+/// Read a pixel of an image, the pixels outside of the image are given by the
+/// border mode (reference for the filters).
+/**
+* @param anImage: the image
+* @param i: the position along the horizontal axis (can be outside)
+* @param j: the position along the vertical axis (can be outside)
+* @param aBorderMode: how to read the pixels outside of the image
+* @param aBorderValue: the pixel value used with BORDER_CONSTANT
+* @return the pixel value
+*/
+//------------------------------------------------------------------------------
+static double getBorderPixel(const ImageView& anImage, int i, int j,
+	Image::BorderMode aBorderMode, float aBorderValue)
+//------------------------------------------------------------------------------
+{
+	const int size_set[2] = { int(anImage.getWidth()), int(anImage.getHeight()) };
+	int index_set[2] = { i, j };
+
+	for (unsigned int k(0); k < 2; ++k)
+	{
+		int& index(index_set[k]);
+		const int size(size_set[k]);
+
+		if (index >= 0 && index < size)
+		{
+			continue;
+		}
+
+		if (aBorderMode == Image::BORDER_CONSTANT)
+		{
+			return (aBorderValue);
+		}
+
+		if (aBorderMode == Image::BORDER_REFLECT && size > 1)
+		{
+			// Bounce on the edge pixels until inside
+			while (index < 0 || index >= size)
+			{
+				index = (index < 0) ? -index : 2 * (size - 1) - index;
+			}
+		}
+		else
+		{
+			index = std::min(std::max(index, 0), size - 1);
+		}
+	}
+
+	return (anImage.getPixel(index_set[0], index_set[1]));
+}
+
+
+//------------------------------------------------------------------------------
+/// Write a file byte by byte.
+/**
+* @param aFileName: the name of the file
+* @param aContent: the bytes of the file
+*/
+//------------------------------------------------------------------------------
+static void writeFile(const std::string& aFileName, const std::string& aContent)
+//------------------------------------------------------------------------------
+{
+	std::ofstream output_file(aFileName.c_str(), std::ofstream::binary);
+	if (!output_file.is_open())
+	{
+		throw ("Cannot create the file \"" + aFileName + "\"");
+	}
+
+	output_file.write(aContent.data(), aContent.size());
+}
+
+
+//------------------------------------------------------------------------------
+/// Check that loading a file throws.
+/**
+* @param aFileName: the name of the file
+* @return true if Image, Image8 and Image16 throw
+*/
+//------------------------------------------------------------------------------
+static bool isLoadingThrown(const std::string& aFileName)
+//------------------------------------------------------------------------------
+{
+	unsigned int thrown_count(0);
+
+	try { Image image; image.loadPGM(aFileName); }
+	catch (const std::string&) { ++thrown_count; }
+
+	try { Image8 image; image.loadPGM(aFileName); }
+	catch (const std::string&) { ++thrown_count; }
+
+	try { Image16 image; image.loadPGM(aFileName); }
+	catch (const std::string&) { ++thrown_count; }
+
+	return (thrown_count == 3);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the methods of convolve.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testConvolution(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image input(createTestImage(67, 45, 1));
+
+	// An explicit method is used even if the kernel is separable (Gaussian
+	// weights: the methods do not round the same way)
+	std::vector<float> kernel(25);
+	for (unsigned int k(0); k < kernel.size(); ++k)
+	{
+		const int x(int(k % 5) - 2), y(int(k / 5) - 2);
+		kernel[k] = std::exp(-float(x * x + y * y) / 3) / 7;
+	}
+
+	const Image direct(input.convolve(kernel, 5, 5, Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_DIRECT));
+	const Image separable(input.convolve(kernel, 5, 5, Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_SEPARABLE));
+	const Image fft(input.convolve(kernel, 5, 5, Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_FFT));
+	printCheck("Separable kernel with CONVOLUTION_SEPARABLE close to direct", getMaxDifference(separable, direct) < 1.0e-3, anErrorCode);
+	printCheck("Separable kernel with CONVOLUTION_FFT close to direct", getMaxDifference(fft, direct) < 1.0e-2, anErrorCode);
+	printCheck("Separable kernel with CONVOLUTION_FFT not processed in two passes", getMaxDifference(fft, separable) > 0, anErrorCode);
+
+	// A 15x13 kernel of pseudo-random weights (not separable), and the outer
+	// product of two Gaussian kernels (separable); the image is large enough
+	// to be split into several FFT tiles
+	const Image large_input(createTestImage(130, 97, 4));
+	const unsigned int kernel_width(15), kernel_height(13);
+	std::vector<float> random_kernel(kernel_width * kernel_height), separable_kernel(kernel_width * kernel_height);
+	unsigned int state(5);
+	for (unsigned int k(0); k < random_kernel.size(); ++k)
+	{
+		const int x(int(k % kernel_width) - int(kernel_width / 2)), y(int(k / kernel_width) - int(kernel_height / 2));
+		state = state * 1664525u + 1013904223u;
+		random_kernel[k] = (float(state >> 24) - 100) / 4000;
+		separable_kernel[k] = std::exp(-float(x * x) / 20) * std::exp(-float(y * y) / 12) / 40;
+	}
+
+	const Image::BorderMode border_mode_set[] = { Image::BORDER_REPLICATE,
+		Image::BORDER_REFLECT, Image::BORDER_CONSTANT };
+	const char* border_mode_name_set[] = { "replicate", "reflect", "constant" };
+	const float border_value(40);
+
+	for (unsigned int m(0); m < 3; ++m)
+	{
+		const Image::BorderMode border_mode(border_mode_set[m]);
+		const std::string mode_name(std::string(" (") + border_mode_name_set[m] + ")");
+
+		// The weighted sum of every neighbourhood
+		const Image random_direct(large_input.convolve(random_kernel, kernel_width, kernel_height,
+			border_mode, border_value, Image::CONVOLUTION_DIRECT));
+		double difference(0);
+		for (int j(0); j < int(large_input.getHeight()); ++j)
+		{
+			for (int i(0); i < int(large_input.getWidth()); ++i)
+			{
+				double sum(0);
+				for (unsigned int k(0); k < random_kernel.size(); ++k)
+				{
+					sum += random_kernel[k] * getBorderPixel(large_input,
+						i + int(k % kernel_width) - int(kernel_width / 2),
+						j + int(k / kernel_width) - int(kernel_height / 2),
+						border_mode, border_value);
+				}
+				difference = std::max(difference, std::abs(random_direct.getPixel(i, j) - sum));
+			}
+		}
+		printCheck("15x13 kernel with CONVOLUTION_DIRECT matches the definition" + mode_name, difference < 1.0e-3, anErrorCode);
+
+		printCheck("15x13 kernel with CONVOLUTION_FFT close to direct" + mode_name,
+			getMaxDifference(large_input.convolve(random_kernel, kernel_width, kernel_height,
+			border_mode, border_value, Image::CONVOLUTION_FFT), random_direct) < 1.0e-2, anErrorCode);
+
+		// A rank-1 kernel is processed in two passes, also when it is detected
+		const Image separable_direct(large_input.convolve(separable_kernel, kernel_width, kernel_height,
+			border_mode, border_value, Image::CONVOLUTION_DIRECT));
+		const Image separable_output(large_input.convolve(separable_kernel, kernel_width, kernel_height,
+			border_mode, border_value, Image::CONVOLUTION_SEPARABLE));
+		printCheck("Separable 15x13 kernel with CONVOLUTION_SEPARABLE close to direct" + mode_name,
+			getMaxDifference(separable_output, separable_direct) < 1.0e-3, anErrorCode);
+		printCheck("Separable 15x13 kernel detected by CONVOLUTION_AUTO" + mode_name,
+			getMaxDifference(large_input.convolve(separable_kernel, kernel_width, kernel_height,
+			border_mode, border_value), separable_output) == 0, anErrorCode);
+	}
+
+	// A kernel that is not rank-1 cannot be processed in two passes
+	bool is_thrown(false);
+	try
+	{
+		large_input.convolve(random_kernel, kernel_width, kernel_height,
+			Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_SEPARABLE);
+	}
+	catch (const char*)
+	{
+		is_thrown = true;
+	}
+	printCheck("15x13 kernel with CONVOLUTION_SEPARABLE throws", is_thrown, anErrorCode);
+
+	// Two 1D kernels of different sizes, not symmetric (they are not flipped)
+	const float horizontal_weight_set[] = { 0.1f, -0.3f, 0.5f, 0.2f, 0.4f, -0.05f, 0.15f };
+	const float vertical_weight_set[] = { 0.6f, 0.3f, 0.1f };
+	const std::vector<float> horizontal_kernel(horizontal_weight_set, horizontal_weight_set + 7);
+	const std::vector<float> vertical_kernel(vertical_weight_set, vertical_weight_set + 3);
+	for (unsigned int m(0); m < 3; ++m)
+	{
+		const Image::BorderMode border_mode(border_mode_set[m]);
+		const Image output(input.convolveSeparable(horizontal_kernel, vertical_kernel, border_mode, border_value));
+
+		double difference(0);
+		for (int j(0); j < int(input.getHeight()); ++j)
+		{
+			for (int i(0); i < int(input.getWidth()); ++i)
+			{
+				double sum(0);
+				for (int y(0); y < int(vertical_kernel.size()); ++y)
+				{
+					for (int x(0); x < int(horizontal_kernel.size()); ++x)
+					{
+						sum += double(vertical_kernel[y]) * horizontal_kernel[x] *
+							getBorderPixel(input, i + x - 3, j + y - 1, border_mode, border_value);
+					}
+				}
+				difference = std::max(difference, std::abs(output.getPixel(i, j) - sum));
+			}
+		}
+		printCheck(std::string("7x3 separable kernel matches the definition (") + border_mode_name_set[m] + ")",
+			difference < 1.0e-3, anErrorCode);
+	}
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the gradients computed in a single pass.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testGradients(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image input(createTestImage(37, 29, 2));
+
+	std::vector<Image::GradientOperator> operator_set;
+	operator_set.push_back(Image::GRADIENT_PREWITT);
+	operator_set.push_back(Image::GRADIENT_SOBEL);
+	operator_set.push_back(Image::GRADIENT_SCHARR);
+	operator_set.push_back(Image::GRADIENT_ROBERTS);
+	const char* operator_name_set[] = { "Prewitt", "Sobel", "Scharr", "Roberts" };
+
+	// Weights (side, centre) smoothing the derivatives
+	const double smoothing_weight_set[3][2] = { { 1, 1 }, { 1, 2 }, { 3, 10 } };
+
+	const Image::BorderMode border_mode_set[] = { Image::BORDER_REPLICATE,
+		Image::BORDER_REFLECT, Image::BORDER_CONSTANT };
+	const char* border_mode_name_set[] = { "replicate", "reflect", "constant" };
+	const char* instruction_set_name_set[] = { "scalar", "SSE", "AVX2" };
+	const float border_value(40);
+
+	const RowKernels::InstructionSet supported_instruction_set(RowKernels::getSupportedInstructionSet());
+	for (unsigned int m(0); m < 3; ++m)
+	{
+		const Image::BorderMode border_mode(border_mode_set[m]);
+
+		std::vector<Image> scalar_magnitude_set, scalar_direction_set;
+		for (int instruction_set(RowKernels::SCALAR); instruction_set <= supported_instruction_set; ++instruction_set)
+		{
+			RowKernels::setInstructionSet(RowKernels::InstructionSet(instruction_set));
+
+			std::vector<Image> magnitude_set, direction_set;
+			input.gradients(operator_set, magnitude_set, &direction_set,
+				Image::GRADIENT_L2, border_mode, border_value);
+
+			for (unsigned int k(0); k < operator_set.size(); ++k)
+			{
+				const std::string name(std::string(operator_name_set[k]) + " gradient (" +
+					border_mode_name_set[m] + ", " + instruction_set_name_set[instruction_set] + ")");
+
+				// The same as one operator at a time
+				Image direction;
+				const Image magnitude(input.gradient(operator_set[k], Image::GRADIENT_L2,
+					&direction, border_mode, border_value));
+				printCheck(name + " with gradients identical to gradient",
+					getMaxDifference(magnitude_set[k], magnitude) == 0 &&
+					getMaxDifference(direction_set[k], direction) == 0, anErrorCode);
+
+				if (instruction_set == RowKernels::SCALAR)
+				{
+					// The same as the definition of the operator
+					double difference(0);
+					for (int j(0); j < int(input.getHeight()); ++j)
+					{
+						for (int i(0); i < int(input.getWidth()); ++i)
+						{
+							double gx(0), gy(0);
+							if (operator_set[k] == Image::GRADIENT_ROBERTS)
+							{
+								gx = getBorderPixel(input, i + 1, j + 1, border_mode, border_value) -
+									getBorderPixel(input, i, j, border_mode, border_value);
+								gy = getBorderPixel(input, i, j + 1, border_mode, border_value) -
+									getBorderPixel(input, i + 1, j, border_mode, border_value);
+							}
+							else
+							{
+								for (int d(-1); d <= 1; ++d)
+								{
+									const double weight(smoothing_weight_set[k][d ? 0 : 1]);
+									gx += weight * (getBorderPixel(input, i + 1, j + d, border_mode, border_value) -
+										getBorderPixel(input, i - 1, j + d, border_mode, border_value));
+									gy += weight * (getBorderPixel(input, i + d, j + 1, border_mode, border_value) -
+										getBorderPixel(input, i + d, j - 1, border_mode, border_value));
+								}
+							}
+
+							difference = std::max(difference,
+								std::abs(magnitude_set[k].getPixel(i, j) - std::sqrt(gx * gx + gy * gy)));
+						}
+					}
+					printCheck(name + " matches the definition", difference < 1.0e-2, anErrorCode);
+				}
+				else
+				{
+					printCheck(name + " identical to scalar",
+						getMaxDifference(magnitude_set[k], scalar_magnitude_set[k]) == 0 &&
+						getMaxDifference(direction_set[k], scalar_direction_set[k]) == 0, anErrorCode);
+				}
+			}
+
+			if (instruction_set == RowKernels::SCALAR)
+			{
+				scalar_magnitude_set = magnitude_set;
+				scalar_direction_set = direction_set;
+			}
+		}
+	}
+	RowKernels::setInstructionSet(supported_instruction_set);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the box blur of any radius.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testBoxBlur(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image input(createTestImage(40, 30, 20));
+
+	const Image::BorderMode border_mode_set[] = { Image::BORDER_REPLICATE,
+		Image::BORDER_REFLECT, Image::BORDER_CONSTANT };
+	const char* border_mode_name_set[] = { "replicate", "reflect", "constant" };
+	const unsigned int radius_set[] = { 0, 1, 31 };
+	const float border_value(40);
+
+	// The average of every neighbourhood
+	for (unsigned int m(0); m < 3; ++m)
+	{
+		const Image::BorderMode border_mode(border_mode_set[m]);
+		for (unsigned int r(0); r < sizeof(radius_set) / sizeof(radius_set[0]); ++r)
+		{
+			const int radius(radius_set[r]);
+			const Image output(input.boxBlur(radius, border_mode, border_value));
+
+			double difference(output.getWidth() == input.getWidth() &&
+				output.getHeight() == input.getHeight() ? 0 : 1);
+			for (int j(0); !difference && j < int(input.getHeight()); ++j)
+			{
+				for (int i(0); i < int(input.getWidth()); ++i)
+				{
+					double sum(0);
+					for (int y(j - radius); y <= j + radius; ++y)
+					{
+						for (int x(i - radius); x <= i + radius; ++x)
+						{
+							sum += getBorderPixel(input, x, y, border_mode, border_value);
+						}
+					}
+
+					difference = std::max(difference, std::abs(output.getPixel(i, j) - sum / ((2 * radius + 1) * (2 * radius + 1))));
+				}
+			}
+
+			std::stringstream name;
+			name << "Box blur of radius " << radius << " (" << border_mode_name_set[m] << ") matches the definition";
+			printCheck(name.str(), difference < 1.0e-3, anErrorCode);
+		}
+	}
+
+	// The row bands processed by several threads give the same result
+	Image::setNumberOfThreads(1);
+	const Image serial_output(input.boxBlur(5));
+	Image::setNumberOfThreads(4);
+	const Image parallel_output(input.boxBlur(5));
+	Image::setNumberOfThreads(1);
+	printCheck("Box blur of radius 5 identical with 1 and 4 threads",
+		getMaxDifference(serial_output, parallel_output) == 0, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the median filter of any radius.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testMedianFilter(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image input(createTestImage(33, 23, 3));
+
+	const Image::BorderMode border_mode_set[] = { Image::BORDER_REPLICATE,
+		Image::BORDER_REFLECT, Image::BORDER_CONSTANT };
+	const char* border_mode_name_set[] = { "replicate", "reflect", "constant" };
+	const unsigned int radius_set[] = { 1, 2, 7, 50 };
+	const float border_value(40);
+
+	// The median of every neighbourhood (its size is odd)
+	for (unsigned int m(0); m < 3; ++m)
+	{
+		const Image::BorderMode border_mode(border_mode_set[m]);
+		for (unsigned int r(0); r < sizeof(radius_set) / sizeof(radius_set[0]); ++r)
+		{
+			const int radius(radius_set[r]);
+			const Image output(input.medianFilter(radius, border_mode, border_value));
+
+			std::vector<double> window;
+			double difference(output.getWidth() == input.getWidth() &&
+				output.getHeight() == input.getHeight() ? 0 : 1);
+			for (int j(0); !difference && j < int(input.getHeight()); ++j)
+			{
+				for (int i(0); i < int(input.getWidth()); ++i)
+				{
+					window.clear();
+					for (int y(j - radius); y <= j + radius; ++y)
+					{
+						for (int x(i - radius); x <= i + radius; ++x)
+						{
+							window.push_back(getBorderPixel(input, x, y, border_mode, border_value));
+						}
+					}
+					std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+
+					difference = std::max(difference, std::abs(output.getPixel(i, j) - window[window.size() / 2]));
+				}
+			}
+
+			std::stringstream name;
+			name << "Median filter of radius " << radius << " (" << border_mode_name_set[m] << ") matches the definition";
+			printCheck(name.str(), difference == 0, anErrorCode);
+		}
+
+		// Same as the 3x3 median filter
+		printCheck(std::string("Median filter of radius 1 (") + border_mode_name_set[m] + ") identical to MEDIAN_FILTER",
+			getMaxDifference(input.medianFilter(1, border_mode, border_value),
+			input.selectFunction_3x3(Image::MEDIAN_FILTER, border_mode, border_value)) == 0, anErrorCode);
+	}
+
+	// The row bands processed by several threads give the same result
+	Image::setNumberOfThreads(1);
+	const Image serial_output(input.medianFilter(7));
+	Image::setNumberOfThreads(4);
+	const Image parallel_output(input.medianFilter(7));
+	Image::setNumberOfThreads(1);
+	printCheck("Median filter of radius 7 identical with 1 and 4 threads",
+		getMaxDifference(serial_output, parallel_output) == 0, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the metrics computed by compare.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testCompare(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image first(createTestImage(53, 41, 6));
+
+	// Identical images
+	const Image::Comparison identical(first.compare(first));
+	printCheck("Comparison of identical images",
+		identical.m_sae == 0 && identical.m_ssd == 0 && identical.m_mse == 0 &&
+		identical.m_psnr == std::numeric_limits<double>::infinity() &&
+		std::abs(identical.m_ncc - 1) < 1.0e-9, anErrorCode);
+
+	// A constant image is not correlated
+	Image constant(first.getWidth(), first.getHeight());
+	constant += 128;
+	printCheck("Comparison with a constant image", first.compare(constant).m_ncc == 0, anErrorCode);
+
+	// A small known difference: every metric computed in double precision
+	Image second(first);
+	second.setPixel(0, 0, second.getPixel(0, 0) + 3);
+	second.setPixel(17, 9, second.getPixel(17, 9) - 0.5f);
+	second.setPixel(52, 40, second.getPixel(52, 40) + 1);
+
+	const double count(double(first.getWidth()) * first.getHeight());
+	double sae(0), ssd(0), first_sum(0), second_sum(0);
+	for (unsigned int j(0); j < first.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < first.getWidth(); ++i)
+		{
+			const double difference(double(first.getPixel(i, j)) - second.getPixel(i, j));
+			sae += std::abs(difference);
+			ssd += difference * difference;
+			first_sum += first.getPixel(i, j);
+			second_sum += second.getPixel(i, j);
+		}
+	}
+
+	double covariance(0), first_variance(0), second_variance(0);
+	for (unsigned int j(0); j < first.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < first.getWidth(); ++i)
+		{
+			const double first_centred(first.getPixel(i, j) - first_sum / count);
+			const double second_centred(second.getPixel(i, j) - second_sum / count);
+			covariance += first_centred * second_centred;
+			first_variance += first_centred * first_centred;
+			second_variance += second_centred * second_centred;
+		}
+	}
+
+	const double mse(ssd / count);
+	const double psnr(10.0 * std::log10(255.0 * 255.0 / mse));
+	const double ncc(covariance / std::sqrt(first_variance * second_variance));
+
+	const Image::Comparison comparison(first.compare(second));
+	printCheck("Comparison with a small difference",
+		std::abs(comparison.m_sae - sae) < 1.0e-6 && std::abs(comparison.m_ssd - ssd) < 1.0e-6 &&
+		std::abs(comparison.m_mse - mse) < 1.0e-9 && std::abs(comparison.m_psnr - psnr) < 1.0e-6 &&
+		std::abs(comparison.m_ncc - ncc) < 1.0e-9, anErrorCode);
+
+	// The rows are added in the same order with any number of threads
+	Image::setNumberOfThreads(4);
+	const Image::Comparison parallel_comparison(first.compare(second));
+	Image::setNumberOfThreads(1);
+	printCheck("Comparison identical with 1 and 4 threads",
+		parallel_comparison.m_sae == comparison.m_sae && parallel_comparison.m_ssd == comparison.m_ssd &&
+		parallel_comparison.m_mse == comparison.m_mse && parallel_comparison.m_psnr == comparison.m_psnr &&
+		parallel_comparison.m_ncc == comparison.m_ncc, anErrorCode);
+
+	// The images must have the same size
+	bool is_thrown(false);
+	try
+	{
+		first.compare(createTestImage(53, 40, 6));
+	}
+	catch (const char*)
+	{
+		is_thrown = true;
+	}
+	printCheck("Comparison of images of different sizes throws", is_thrown, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the parser of the PGM files and the mapping of the raw files.
+/**
+* @param aPath: the directory where the files are written
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testFiles(const std::string& aPath, int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// Comments between the fields of the header and between the pixels
+	const std::string comment_file_name(aPath + "comments.pgm");
+	writeFile(comment_file_name, "P2\n# width\n3 # height\n#\n2\n# max value\n255\n1 2 3\n4 5 # last\n6\n");
+	Image image;
+	Image8 image_8;
+	image.loadPGM(comment_file_name);
+	image_8.loadPGM(comment_file_name);
+	bool is_valid(image.getWidth() == 3 && image.getHeight() == 2 &&
+		image_8.getWidth() == 3 && image_8.getHeight() == 2);
+	for (unsigned int k(0); is_valid && k < 6; ++k)
+	{
+		is_valid = image.getPixel(k % 3, k / 3) == k + 1 && image_8.getPixel(k % 3, k / 3) == k + 1;
+	}
+	printCheck("PGM file with comments in the header", is_valid, anErrorCode);
+
+	// Missing pixels
+	const std::string truncated_ascii_file_name(aPath + "truncated_ascii.pgm");
+	writeFile(truncated_ascii_file_name, "P2\n3 2\n255\n1 2 3 4\n");
+	printCheck("Truncated P2 file throws", isLoadingThrown(truncated_ascii_file_name), anErrorCode);
+
+	const std::string truncated_binary_file_name(aPath + "truncated_binary.pgm");
+	writeFile(truncated_binary_file_name, std::string("P5\n3 2\n255\n") + std::string(5, char(7)));
+	printCheck("Truncated P5 file throws", isLoadingThrown(truncated_binary_file_name), anErrorCode);
+
+	// Two bytes per pixel, the most significant first
+	const std::string binary_16_file_name(aPath + "binary_16.pgm");
+	const char pixel_byte_set[] = { 0x01, 0x02, char(0xFF), char(0xFF), 0x00, 0x07, char(0x80), 0x00 };
+	writeFile(binary_16_file_name, std::string("P5\n2 2\n65535\n") + std::string(pixel_byte_set, 8));
+	Image16 image_16;
+	image.loadPGM(binary_16_file_name);
+	image_16.loadPGM(binary_16_file_name);
+	const unsigned int pixel_value_set[] = { 258, 65535, 7, 32768 };
+	is_valid = image.getWidth() == 2 && image.getHeight() == 2 &&
+		image_16.getWidth() == 2 && image_16.getHeight() == 2;
+	for (unsigned int k(0); is_valid && k < 4; ++k)
+	{
+		is_valid = image.getPixel(k % 2, k / 2) == pixel_value_set[k] &&
+			image_16.getPixel(k % 2, k / 2) == pixel_value_set[k];
+	}
+	printCheck("16-bit P5 file", is_valid, anErrorCode);
+
+	// A raw file is viewed in place, its size must match
+	const std::string raw_file_name(aPath + "raw_view.raw");
+	Image raw_image(createTestImage(19, 7, 8));
+	raw_image.saveRaw(raw_file_name);
+	MappedFile raw_file;
+	is_valid = raw_file.open(raw_file_name.c_str()) &&
+		getMaxDifference(raw_file.getRawView(19, 7), raw_image) == 0;
+
+	bool is_thrown(false);
+	try
+	{
+		raw_file.getRawView(20, 7);
+	}
+	catch (const std::string&)
+	{
+		is_thrown = true;
+	}
+	printCheck("View of a raw file", is_valid && is_thrown, anErrorCode);
+
+	// Binary files saved and loaded: the maximum value of the file is the one
+	// of the data, so 8-bit data are not rescaled in an Image8
+	const Image input_8(createTestImage(23, 11, 9));
+	Image input_16(input_8 * 3.0f);
+	input_16.setPixel(5, 5, 1000);
+	const Image::PGMFormat format_set[] = { Image::PGM_BINARY_8, Image::PGM_BINARY_16 };
+	const char* format_name_set[] = { "8-bit", "16-bit" };
+	for (unsigned int k(0); k < 2; ++k)
+	{
+		const std::string file_name(aPath + "round_trip.pgm");
+		Image(input_8).savePGM(file_name, format_set[k]);
+		image.loadPGM(file_name);
+		image_8.loadPGM(file_name);
+
+		MappedFile file;
+		MappedFile::PGMHeader header;
+		is_valid = file.open(file_name.c_str()) && file.readPGMHeader(header) &&
+			header.m_max_value == 255 && header.m_bytes_per_pixel == 1;
+		is_valid = is_valid && getMaxDifference(image, input_8) == 0;
+		for (unsigned int j(0); is_valid && j < input_8.getHeight(); ++j)
+		{
+			for (unsigned int i(0); is_valid && i < input_8.getWidth(); ++i)
+			{
+				is_valid = image_8.getPixel(i, j) == input_8.getPixel(i, j);
+			}
+		}
+		printCheck(std::string(format_name_set[k]) + " P5 file saved and loaded", is_valid, anErrorCode);
+	}
+
+	const std::string file_name_16(aPath + "round_trip_16.pgm");
+	input_16.savePGM(file_name_16, Image::PGM_BINARY_16);
+	image.loadPGM(file_name_16);
+	MappedFile file_16;
+	MappedFile::PGMHeader header_16;
+	printCheck("16-bit P5 file with values above 255 saved and loaded",
+		file_16.open(file_name_16.c_str()) && file_16.readPGMHeader(header_16) &&
+		header_16.m_max_value == 1000 && header_16.m_bytes_per_pixel == 2 &&
+		getMaxDifference(image, input_16) == 0, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the pixelwise arithmetic of the expressions.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testExpressions(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image first(createTestImage(31, 17, 10));
+	const Image second(createTestImage(31, 17, 11));
+	const Image third(createTestImage(31, 17, 12));
+
+	// Several operators in a single loop
+	const Image output(first * 0.5f + second * 0.5f - third);
+	Image reference(first);
+	for (unsigned int j(0); j < reference.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < reference.getWidth(); ++i)
+		{
+			reference.setPixel(i, j, first.getPixel(i, j) * 0.5f + second.getPixel(i, j) * 0.5f - third.getPixel(i, j));
+		}
+	}
+	printCheck("Expression identical to a loop over the pixels", getMaxDifference(output, reference) == 0, anErrorCode);
+
+	// The current image in the expression
+	Image in_place(first);
+	in_place = in_place * 2.0f + second;
+	const Image copy(first * 2.0f + second);
+	printCheck("Expression computed in place", getMaxDifference(in_place, copy) == 0, anErrorCode);
+
+	// The result has the size of the smallest image, also in place
+	const Image small_image(createTestImage(20, 9, 13));
+	const Image small_output(first + small_image);
+	in_place = first;
+	in_place = in_place + small_image;
+	bool is_valid(small_output.getWidth() == 20 && small_output.getHeight() == 9 &&
+		getMaxDifference(in_place, small_output) == 0);
+	for (unsigned int j(0); is_valid && j < small_output.getHeight(); ++j)
+	{
+		for (unsigned int i(0); is_valid && i < small_output.getWidth(); ++i)
+		{
+			is_valid = small_output.getPixel(i, j) == first.getPixel(i, j) + small_image.getPixel(i, j);
+		}
+	}
+	printCheck("Expression with a smaller image", is_valid, anErrorCode);
+
+	// The division is checked when the expression is built
+	bool is_thrown(false);
+	try
+	{
+		const Image division(first / 0.0f);
+	}
+	catch (const char*)
+	{
+		is_thrown = true;
+	}
+	printCheck("Expression dividing by zero throws", is_thrown, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the addition and subtraction of images in place.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testAccumulation(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image first(createTestImage(31, 17, 14));
+	const Image second(createTestImage(31, 17, 15));
+
+	// Sums accumulated in place, in packed and aligned storage
+	for (unsigned int k(0); k < 2; ++k)
+	{
+		Image output(first);
+		if (k)
+		{
+			output.setAlignedStorage();
+		}
+		output += second;
+		output += second;
+		output -= first;
+
+		Image reference(first);
+		for (unsigned int j(0); j < reference.getHeight(); ++j)
+		{
+			for (unsigned int i(0); i < reference.getWidth(); ++i)
+			{
+				reference.setPixel(i, j, first.getPixel(i, j) + second.getPixel(i, j) + second.getPixel(i, j) - first.getPixel(i, j));
+			}
+		}
+		printCheck(std::string("Images accumulated in place (") + (k ? "aligned" : "packed") + ")",
+			getMaxDifference(output, reference) == 0, anErrorCode);
+	}
+
+	// A view of a larger image (its stride is not its width)
+	const Image large_image(createTestImage(40, 30, 16));
+	const ImageView view(large_image.getView(3, 2, 31, 17));
+	Image view_output(first);
+	view_output += view;
+	bool is_valid(true);
+	for (unsigned int j(0); is_valid && j < first.getHeight(); ++j)
+	{
+		for (unsigned int i(0); is_valid && i < first.getWidth(); ++i)
+		{
+			is_valid = view_output.getPixel(i, j) == first.getPixel(i, j) + large_image.getPixel(i + 3, j + 2);
+		}
+	}
+	printCheck("View added in place", is_valid, anErrorCode);
+
+	// Only the area common to both images is kept
+	const Image small_image(createTestImage(20, 9, 17));
+	Image small_output(first);
+	small_output -= small_image;
+	is_valid = small_output.getWidth() == 20 && small_output.getHeight() == 9;
+	for (unsigned int j(0); is_valid && j < small_output.getHeight(); ++j)
+	{
+		for (unsigned int i(0); is_valid && i < small_output.getWidth(); ++i)
+		{
+			is_valid = small_output.getPixel(i, j) == first.getPixel(i, j) - small_image.getPixel(i, j);
+		}
+	}
+	printCheck("Smaller image subtracted in place", is_valid, anErrorCode);
+
+	// The current image as the operand
+	Image twice(first);
+	twice += twice;
+	Image zero(first);
+	zero -= zero;
+	printCheck("Image added to itself", getMaxDifference(twice, Image(first * 2.0f)) == 0, anErrorCode);
+	printCheck("Image subtracted from itself", getMaxDifference(zero, Image(first.getWidth(), first.getHeight())) == 0, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the saturating arithmetic of an integer image with every instruction
+/// set.
+/**
+* @param aName: the name of the image type
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+template<typename T>
+static void testPixelArithmetic(const std::string& aName, int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// Pseudo-random values, and pairs that overflow at 0 and at the maximum
+	// (the width covers the SIMD loops and their remainders)
+	const unsigned int max_value(PixelImage<T>::getMaxPixelValue());
+	PixelImage<T> first(67, 5), second(67, 5);
+	unsigned int state(18);
+	for (unsigned int j(0); j < first.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < first.getWidth(); ++i)
+		{
+			state = state * 1664525u + 1013904223u;
+			first.setPixel(i, j, T((state >> 8) % (max_value + 1)));
+			state = state * 1664525u + 1013904223u;
+			second.setPixel(i, j, T((state >> 8) % (max_value + 1)));
+		}
+	}
+	first.setPixel(0, 0, T(max_value));
+	second.setPixel(0, 0, T(max_value));
+	first.setPixel(1, 0, T(max_value - 1));
+	second.setPixel(1, 0, 2);
+	first.setPixel(2, 0, 0);
+	second.setPixel(2, 0, 1);
+
+	const char* instruction_set_name_set[] = { "scalar", "SSE", "AVX2" };
+	const RowKernels::InstructionSet supported_instruction_set(RowKernels::getSupportedInstructionSet());
+	for (int instruction_set(RowKernels::SCALAR); instruction_set <= supported_instruction_set; ++instruction_set)
+	{
+		RowKernels::setInstructionSet(RowKernels::InstructionSet(instruction_set));
+
+		const PixelImage<T> sum(first + second);
+		const PixelImage<T> difference(first - second);
+		bool is_valid(true);
+		for (unsigned int j(0); is_valid && j < first.getHeight(); ++j)
+		{
+			for (unsigned int i(0); is_valid && i < first.getWidth(); ++i)
+			{
+				const int first_value(first.getPixel(i, j)), second_value(second.getPixel(i, j));
+				is_valid = sum.getPixel(i, j) == std::min(int(max_value), first_value + second_value) &&
+					difference.getPixel(i, j) == std::max(0, first_value - second_value);
+			}
+		}
+		printCheck(aName + " saturating addition and subtraction (" +
+			instruction_set_name_set[instruction_set] + ")", is_valid, anErrorCode);
+	}
+	RowKernels::setInstructionSet(supported_instruction_set);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the conversions of the integer images.
+/**
+* @param aPath: the directory where the files are written
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testPixelImages(const std::string& aPath, int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	testPixelArithmetic<std::uint8_t>("Image8", anErrorCode);
+	testPixelArithmetic<std::uint16_t>("Image16", anErrorCode);
+
+	// Rounded to the nearest, clamped, NaN gives 0 (the row is long enough
+	// for the SIMD loops)
+	const float value_set[] = { 2.5f, 2.49f, -3, 300, 70000, std::numeric_limits<float>::quiet_NaN(), 254.6f, 0.5f };
+	const unsigned int value_count(sizeof(value_set) / sizeof(value_set[0]));
+	const unsigned int value_8_set[] = { 3, 2, 0, 255, 255, 0, 255, 1 };
+	const unsigned int value_16_set[] = { 3, 2, 0, 300, 65535, 0, 255, 1 };
+
+	Image input(4 * value_count + 3, 1);
+	for (unsigned int i(0); i < input.getWidth(); ++i)
+	{
+		input.setPixel(i, 0, value_set[i % value_count]);
+	}
+
+	const char* instruction_set_name_set[] = { "scalar", "SSE", "AVX2" };
+	const RowKernels::InstructionSet supported_instruction_set(RowKernels::getSupportedInstructionSet());
+	for (int instruction_set(RowKernels::SCALAR); instruction_set <= supported_instruction_set; ++instruction_set)
+	{
+		RowKernels::setInstructionSet(RowKernels::InstructionSet(instruction_set));
+
+		Image8 image_8;
+		Image16 image_16;
+		image_8.convertFrom(input);
+		image_16.convertFrom(input);
+		bool is_valid(true);
+		for (unsigned int i(0); is_valid && i < input.getWidth(); ++i)
+		{
+			is_valid = image_8.getPixel(i, 0) == value_8_set[i % value_count] &&
+				image_16.getPixel(i, 0) == value_16_set[i % value_count];
+		}
+		printCheck(std::string("Float pixels converted to Image8 and Image16 (") +
+			instruction_set_name_set[instruction_set] + ")", is_valid, anErrorCode);
+	}
+	RowKernels::setInstructionSet(supported_instruction_set);
+
+	// The values of a file with a larger range are rescaled, the others are
+	// kept as they are
+	const std::string file_name(aPath + "rescaled.pgm");
+	writeFile(file_name, "P2\n4 1\n1000\n0 500 1000 999\n");
+	Image8 image_8;
+	Image16 image_16;
+	image_8.loadPGM(file_name);
+	image_16.loadPGM(file_name);
+	printCheck("PGM file with a larger range rescaled in an Image8",
+		image_8.getPixel(0, 0) == 0 && image_8.getPixel(1, 0) == 128 &&
+		image_8.getPixel(2, 0) == 255 && image_8.getPixel(3, 0) == 255 &&
+		image_16.getPixel(1, 0) == 500 && image_16.getPixel(3, 0) == 999, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the processing of a view of a region of interest.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testViews(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// The view reads the pixels of the image (its stride is not its width),
+	// the ROI is a copy: same results
+	const Image input(createTestImage(60, 40, 27));
+	const ImageView view(input.getView(7, 5, 33, 21));
+	const Image roi(input.getROI(7, 5, 33, 21));
+
+	const int function_set[] = { Image::MEDIAN_FILTER, Image::LAPLACIAN_FILTER,
+		Image::GAUSSIAN_BLUR, Image::BOX_BLUR, Image::SHARPEN_FILTER,
+		Image::PREWITT_FILTER, Image::SOBEL_FILTER };
+	bool is_valid(true);
+	for (unsigned int k(0); k < sizeof(function_set) / sizeof(function_set[0]); ++k)
+	{
+		is_valid = is_valid && getMaxDifference(view.selectFunction_3x3(function_set[k]),
+			roi.selectFunction_3x3(function_set[k])) == 0;
+	}
+	const std::vector<float> kernel(25, 1.0f / 25);
+	is_valid = is_valid &&
+		getMaxDifference(view.boxBlur(3), roi.boxBlur(3)) == 0 &&
+		getMaxDifference(view.medianFilter(2), roi.medianFilter(2)) == 0 &&
+		getMaxDifference(view.gradient(Image::GRADIENT_SOBEL), roi.gradient(Image::GRADIENT_SOBEL)) == 0 &&
+		getMaxDifference(view.convolve(kernel, 5, 5, Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_DIRECT),
+		roi.convolve(kernel, 5, 5, Image::BORDER_REPLICATE, 0, Image::CONVOLUTION_DIRECT)) == 0;
+	printCheck("Filters of a view identical to the ones of a ROI", is_valid, anErrorCode);
+
+	const Image::Statistics view_statistics(view.computeStats());
+	const Image::Statistics roi_statistics(roi.computeStats());
+	printCheck("Statistics of a view identical to the ones of a ROI",
+		view_statistics.m_min_value == roi_statistics.m_min_value &&
+		view_statistics.m_max_value == roi_statistics.m_max_value &&
+		view_statistics.m_mean == roi_statistics.m_mean &&
+		view_statistics.m_variance == roi_statistics.m_variance &&
+		view.getHistogram(16) == roi.getHistogram(16) &&
+		view.compare(roi).m_sae == 0, anErrorCode);
+
+	printCheck("View of a view identical to a ROI of a ROI",
+		getMaxDifference(view.getView(2, 3, 10, 8), roi.getROI(2, 3, 10, 8)) == 0, anErrorCode);
+
+	// The region must be inside of the view
+	unsigned int thrown_count(0);
+	try { view.getView(30, 0, 4, 1); }
+	catch (const char*) { ++thrown_count; }
+
+	try { view.getView(0, 20, 1, 2); }
+	catch (const char*) { ++thrown_count; }
+
+	try { view.getView(1, 0, std::numeric_limits<unsigned int>::max(), 1); }
+	catch (const char*) { ++thrown_count; }
+
+	printCheck("View outside of the view throws", thrown_count == 3, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the methods writing into an existing image.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testOutputImages(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image input(createTestImage(45, 27, 25));
+	const Image other_input(createTestImage(45, 27, 26));
+
+	// Same as the versions returning a new image, also when the output is
+	// the input; the buffer of an output of the right size is reused
+	const int function_set[] = { Image::MEDIAN_FILTER, Image::LAPLACIAN_FILTER,
+		Image::GAUSSIAN_BLUR, Image::BOX_BLUR, Image::SHARPEN_FILTER,
+		Image::PREWITT_FILTER, Image::SOBEL_FILTER };
+	const char* function_name_set[] = { "median filter", "Laplacian filter",
+		"Gaussian blur", "box blur", "sharpen filter", "Prewitt filter", "Sobel filter" };
+	for (unsigned int k(0); k < sizeof(function_set) / sizeof(function_set[0]); ++k)
+	{
+		const Image reference(input.selectFunction_3x3(function_set[k]));
+
+		Image output(input.getWidth(), input.getHeight());
+		const float* p_pixels(output.getRow(0));
+		input.selectFunction_3x3(function_set[k], output);
+
+		Image in_place(input);
+		in_place.selectFunction_3x3(function_set[k], in_place);
+
+		printCheck(std::string(function_name_set[k]) + " into an existing image",
+			output.getRow(0) == p_pixels && getMaxDifference(output, reference) == 0 &&
+			getMaxDifference(in_place, reference) == 0, anErrorCode);
+	}
+
+	const Image blend_reference(input.blendImage(other_input, 0.3f));
+	Image blend_output, first_blend(input), second_blend(other_input);
+	input.blendImage(other_input, 0.3f, blend_output);
+	first_blend.blendImage(other_input, 0.3f, first_blend);
+	input.blendImage(second_blend, 0.3f, second_blend);
+	printCheck("Blending into an existing image",
+		getMaxDifference(blend_output, blend_reference) == 0 &&
+		getMaxDifference(first_blend, blend_reference) == 0 &&
+		getMaxDifference(second_blend, blend_reference) == 0, anErrorCode);
+
+	const Image segment_reference(input.segmentImage(125));
+	Image segment_output, segment_in_place(input);
+	input.segmentImage(125, segment_output);
+	segment_in_place.segmentImage(125, segment_in_place);
+	printCheck("Segmentation into an existing image",
+		getMaxDifference(segment_output, segment_reference) == 0 &&
+		getMaxDifference(segment_in_place, segment_reference) == 0, anErrorCode);
+
+	Image invert_input(input);
+	const Image invert_reference(!invert_input);
+	Image invert_output;
+	input.invert(invert_output);
+	invert_input.invert(invert_input);
+	printCheck("Negative into an existing image",
+		getMaxDifference(invert_output, invert_reference) == 0 &&
+		getMaxDifference(invert_input, invert_reference) == 0, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the transfer of the pixels between images.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testMoveAndSwap(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	const Image reference(createTestImage(29, 13, 22));
+
+	// The pixels are transferred, the moved-from image is empty and usable
+	Image source(reference);
+	const float* p_pixels(source.getRow(0));
+	Image moved(std::move(source));
+	bool is_valid(moved.getRow(0) == p_pixels && getMaxDifference(moved, reference) == 0 &&
+		!source.getWidth() && !source.getHeight());
+	source = reference;
+	is_valid = is_valid && getMaxDifference(source, reference) == 0;
+	printCheck("Image moved by the move constructor", is_valid, anErrorCode);
+
+	Image assigned(createTestImage(5, 5, 23));
+	p_pixels = moved.getRow(0);
+	assigned = std::move(moved);
+	is_valid = assigned.getRow(0) == p_pixels && getMaxDifference(assigned, reference) == 0 &&
+		!moved.getWidth() && !moved.getHeight();
+	moved += reference;
+	is_valid = is_valid && !moved.getWidth() && !moved.getHeight();
+	printCheck("Image moved by the move assignment", is_valid, anErrorCode);
+
+	// The storage is exchanged with the pixels
+	const Image other_reference(createTestImage(17, 23, 24));
+	Image aligned_image(reference), packed_image(other_reference);
+	aligned_image.setAlignedStorage(2);
+	aligned_image.fillHalo(Image::BORDER_REFLECT);
+	const unsigned int aligned_stride(aligned_image.getStride());
+	const float* p_aligned_pixels(aligned_image.getRow(0));
+	swap(aligned_image, packed_image);
+	printCheck("Aligned and packed images swapped",
+		packed_image.isAligned() && packed_image.getHaloSize() == 2 &&
+		packed_image.getStride() == aligned_stride && packed_image.getRow(0) == p_aligned_pixels &&
+		getMaxDifference(packed_image, reference) == 0 &&
+		!aligned_image.isAligned() && aligned_image.getStride() == other_reference.getWidth() &&
+		getMaxDifference(aligned_image, other_reference) == 0, anErrorCode);
+	printCheck("Swapped images filtered",
+		getMaxDifference(packed_image.boxBlur(2, Image::BORDER_REFLECT), reference.boxBlur(2, Image::BORDER_REFLECT)) == 0 &&
+		getMaxDifference(aligned_image.boxBlur(2, Image::BORDER_REFLECT), other_reference.boxBlur(2, Image::BORDER_REFLECT)) == 0,
+		anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the statistics of the pixels.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testStatistics(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// A large offset: the sums of the squares would lose the variance
+	Image input(createTestImage(77, 51, 21));
+	input += 100000;
+
+	// Two passes in double precision
+	const double count(double(input.getWidth()) * input.getHeight());
+	double sum(0), square_sum(0);
+	float min_value(input.getPixel(0, 0)), max_value(input.getPixel(0, 0));
+	for (unsigned int j(0); j < input.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < input.getWidth(); ++i)
+		{
+			sum += input.getPixel(i, j);
+			min_value = std::min(min_value, input.getPixel(i, j));
+			max_value = std::max(max_value, input.getPixel(i, j));
+		}
+	}
+	const double mean(sum / count);
+	for (unsigned int j(0); j < input.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < input.getWidth(); ++i)
+		{
+			square_sum += (input.getPixel(i, j) - mean) * (input.getPixel(i, j) - mean);
+		}
+	}
+	const double variance(square_sum / count);
+
+	const Image::Statistics statistics(input.computeStats());
+	printCheck("Statistics of pixels with a large offset",
+		statistics.m_min_value == min_value && statistics.m_max_value == max_value &&
+		std::abs(statistics.m_mean - mean) < 1.0e-2 &&
+		std::abs(statistics.m_variance - variance) < 1.0e-5 * variance &&
+		std::abs(statistics.m_standard_deviation - std::sqrt(variance)) < 1.0e-5 * std::sqrt(variance), anErrorCode);
+
+	// No pixel
+	bool is_thrown(false);
+	try
+	{
+		Image().computeStats();
+	}
+	catch (const char*)
+	{
+		is_thrown = true;
+	}
+	printCheck("Statistics of an empty image throws", is_thrown, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the histograms.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testHistograms(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	Image input(createTestImage(200, 150, 19));
+	input.setPixel(0, 0, 1000);
+
+	// Every pixel is counted, the maximum is in the last bin (it is the only
+	// pixel above 255)
+	const std::vector<unsigned int> histogram(input.getHistogram(10));
+	unsigned int count(0);
+	for (unsigned int k(0); k < histogram.size(); ++k)
+	{
+		count += histogram[k];
+	}
+	printCheck("Histogram counting every pixel",
+		histogram.size() == 10 && count == input.getWidth() * input.getHeight(), anErrorCode);
+	printCheck("Histogram with the maximum in the last bin", histogram.back() == 1, anErrorCode);
+
+	// The pixels outside of the range are not counted, the upper bound is
+	// in the last bin
+	const std::vector<unsigned int> range_histogram(input.getHistogram(4, 0, 255));
+	unsigned int range_count(0), reference_count(0), max_count(0);
+	for (unsigned int k(0); k < range_histogram.size(); ++k)
+	{
+		range_count += range_histogram[k];
+	}
+	for (unsigned int j(0); j < input.getHeight(); ++j)
+	{
+		for (unsigned int i(0); i < input.getWidth(); ++i)
+		{
+			reference_count += (input.getPixel(i, j) <= 255);
+			max_count += (input.getPixel(i, j) == 255);
+		}
+	}
+	printCheck("Histogram of a range", range_count == reference_count && max_count &&
+		range_histogram.back() >= max_count, anErrorCode);
+
+	// The bins of the threads are added: same result as a single thread
+	Image::setNumberOfThreads(1);
+	const std::vector<unsigned int> serial_histogram(input.getHistogram(37));
+	const std::vector<unsigned int> serial_range_histogram(input.getHistogram(16, 10, 200));
+	const std::vector<unsigned int> serial_8_bit_histogram(input.get8BitHistogram());
+	Image::setNumberOfThreads(4);
+	const bool is_identical(input.getHistogram(37) == serial_histogram &&
+		input.getHistogram(16, 10, 200) == serial_range_histogram &&
+		input.get8BitHistogram() == serial_8_bit_histogram);
+	Image::setNumberOfThreads(1);
+	printCheck("Histograms identical with 1 and 4 threads", is_identical, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test the statistics of the buffer pool.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testBufferPool(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// Nothing cached, the images of the caller may still use buffers
+	BufferPool::clear();
+	BufferPool::resetStatistics();
+	const BufferPool::Statistics initial_statistics(BufferPool::getStatistics());
+
+	// The first buffer comes from the system, the second one of the same
+	// size from the cache
+	float* p_first_buffer(BufferPool::allocate(1000));
+	const BufferPool::Statistics allocated_statistics(BufferPool::getStatistics());
+	const std::size_t byte_count(allocated_statistics.m_used_bytes - initial_statistics.m_used_bytes);
+	BufferPool::release(p_first_buffer, 1000);
+	const BufferPool::Statistics released_statistics(BufferPool::getStatistics());
+	float* p_second_buffer(BufferPool::allocate(1000));
+	BufferPool::release(p_second_buffer, 1000);
+	const BufferPool::Statistics statistics(BufferPool::getStatistics());
+
+	printCheck("Buffer pool hit and miss counts",
+		initial_statistics.m_hit_count == 0 && initial_statistics.m_miss_count == 0 &&
+		allocated_statistics.m_miss_count == 1 && allocated_statistics.m_hit_count == 0 &&
+		statistics.m_miss_count == 1 && statistics.m_hit_count == 1 &&
+		p_second_buffer == p_first_buffer, anErrorCode);
+	printCheck("Buffer pool used, cached and peak bytes",
+		byte_count >= 1000 * sizeof(float) &&
+		released_statistics.m_used_bytes == initial_statistics.m_used_bytes &&
+		released_statistics.m_cached_bytes == initial_statistics.m_cached_bytes + byte_count &&
+		statistics.m_cached_bytes == released_statistics.m_cached_bytes &&
+		statistics.m_peak_bytes == initial_statistics.m_used_bytes + byte_count, anErrorCode);
+
+	// The cached buffers are given back to the system
+	BufferPool::clear();
+	const BufferPool::Statistics cleared_statistics(BufferPool::getStatistics());
+	printCheck("Buffer pool cleared",
+		cleared_statistics.m_cached_bytes == 0 &&
+		cleared_statistics.m_used_bytes == initial_statistics.m_used_bytes, anErrorCode);
+}
+
+
+//------------------------------------------------------------------------------
+/// Test that a halo is not used once the pixels are modified.
+/**
+* @param anErrorCode: set to 1 if a check failed
+*/
+//------------------------------------------------------------------------------
+static void testHalo(int& anErrorCode)
+//------------------------------------------------------------------------------
+{
+	// A pixel written through a row pointer invalidates the halo: the
+	// filters give the same result with and without the halo
+	Image halo_image(8, 8), packed_image(8, 8);
+	halo_image.setAlignedStorage(2);
+	halo_image += 1;
+	packed_image += 1;
+	halo_image.fillHalo(Image::BORDER_REPLICATE);
+	const ImageView view(halo_image);
+	halo_image.getRow(0)[0] = 100;
+	packed_image.getRow(0)[0] = 100;
+
+	const Image packed_output(packed_image.selectFunction_3x3(Image::SHARPEN_FILTER));
+	printCheck("Halo after a write through a row pointer",
+		getMaxDifference(halo_image.selectFunction_3x3(Image::SHARPEN_FILTER), packed_output) == 0, anErrorCode);
+
+	// A view copied before the modification does not use the halo either
+	printCheck("Halo of a copied view after a write through a row pointer",
+		getMaxDifference(view.selectFunction_3x3(Image::SHARPEN_FILTER), packed_output) == 0, anErrorCode);
+	printCheck("Halo of a copied view with a gradient",
+		getMaxDifference(view.gradient(Image::GRADIENT_SOBEL), packed_image.gradient(Image::GRADIENT_SOBEL)) == 0, anErrorCode);
+	printCheck("Halo of a copied view with a box blur",
+		getMaxDifference(view.boxBlur(1), packed_image.boxBlur(1)) == 0, anErrorCode);
+}
 
 
 //-----------------------------
@@ -38,97 +1460,174 @@ int main(int argc, char** argv)
     // Catch exceptions
     try
     {
+		// Directory of the test data (can be given on the command line)
+		const std::string data_path(argc > 1 ? argv[1] :
+				"C:/Programs/C++/computer vision/Assignments/CV Assignment 2/test_data/");
+
+		// The tests that do not read the test data
+		testHalo(error_code);
+		testConvolution(error_code);
+		testGradients(error_code);
+		testBoxBlur(error_code);
+		testMedianFilter(error_code);
+		testCompare(error_code);
+		testFiles(data_path + "Results/", error_code);
+		testExpressions(error_code);
+		testAccumulation(error_code);
+		testPixelImages(data_path + "Results/", error_code);
+		testMoveAndSwap(error_code);
+		testOutputImages(error_code);
+		testViews(error_code);
+		testStatistics(error_code);
+		testHistograms(error_code);
+		testBufferPool(error_code);
+
 			// Load an image
 		Image input_1, input_2, input_3, input_4;
-		input_1.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\enterprise.pgm");
-		input_2.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\brian_kernighan.pgm");
-		input_3.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\lena512.pgm");
-		input_4.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\ent_noise.pgm");
+		input_1.loadPGM(data_path + "enterprise.pgm");
+		input_2.loadPGM(data_path + "brian_kernighan.pgm");
+		input_3.loadPGM(data_path + "lena512.pgm");
+		input_4.loadPGM(data_path + "ent_noise.pgm");
 
 		//load reference images
 		Image ref_1, ref_2, ref_3, ref_4, ref_5, ref_6, ref_7, ref_8;
-		ref_1.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\medianFilter.pgm");
-		ref_2.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\laplacian.pgm");
-		ref_3.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\gaussianBlur.pgm");
-		ref_4.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\boxblur.pgm");
-		ref_5.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\sharperImg.pgm");
-		ref_6.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\segmented.pgm");
-		ref_7.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\prewitt.pgm");
-		ref_8.loadPGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\Reference\\sobel.pgm");
+		ref_1.loadPGM(data_path + "Reference/medianFilter.pgm");
+		ref_2.loadPGM(data_path + "Reference/laplacian.pgm");
+		ref_3.loadPGM(data_path + "Reference/gaussianBlur.pgm");
+		ref_4.loadPGM(data_path + "Reference/boxblur.pgm");
+		ref_5.loadPGM(data_path + "Reference/sharperImg.pgm");
+		ref_6.loadPGM(data_path + "Reference/segmented.pgm");
+		ref_7.loadPGM(data_path + "Reference/prewitt.pgm");
+		ref_8.loadPGM(data_path + "Reference/sobel.pgm");
 		
 		//test output
 		Image medianFilteredImage; 
-		medianFilteredImage = input_4.selectFunction_3x3(0);
-		medianFilteredImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\median_filter_out.pgm");
-		medianFilteredImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\median_filter_out.ascii");
-		medianFilteredImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\median_filter_out.raw");
+		medianFilteredImage = input_4.selectFunction_3x3(Image::MEDIAN_FILTER);
+		medianFilteredImage.savePGM(data_path + "Results/median_filter_out.pgm");
+		medianFilteredImage.saveASCII(data_path + "Results/median_filter_out.ascii");
+		medianFilteredImage.saveRaw(data_path + "Results/median_filter_out.raw");
 		std::cout << (std::abs(medianFilteredImage.getNCC(ref_1) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(medianFilteredImage.getSAE(ref_1)) << std::endl;
 
 		Image laplacianFilterImage;
-		laplacianFilterImage = input_1.selectFunction_3x3(1);
-		laplacianFilterImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\laplacian_edgedetection_out.pgm");
-		laplacianFilterImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\laplacian_degedetection_out.ascii");
-		laplacianFilterImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\laplacian_edgedetection_out.raw");
+		laplacianFilterImage = input_1.selectFunction_3x3(Image::LAPLACIAN_FILTER);
+		laplacianFilterImage.savePGM(data_path + "Results/laplacian_edgedetection_out.pgm");
+		laplacianFilterImage.saveASCII(data_path + "Results/laplacian_degedetection_out.ascii");
+		laplacianFilterImage.saveRaw(data_path + "Results/laplacian_edgedetection_out.raw");
 		std::cout << (std::abs(laplacianFilterImage.getNCC(ref_2) - 1.0) < 1.0e-3? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(laplacianFilterImage.getSAE(ref_2)) << std::endl;
 
 		Image gaussianBlurImage;
-		gaussianBlurImage = input_4.selectFunction_3x3(2);
-		gaussianBlurImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\gaussian_blur_out.pgm");
-		gaussianBlurImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\gaussian_blur_out.ascii");
-		gaussianBlurImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\gaussian_blur_out.raw");
+		gaussianBlurImage = input_4.selectFunction_3x3(Image::GAUSSIAN_BLUR);
+		gaussianBlurImage.savePGM(data_path + "Results/gaussian_blur_out.pgm");
+		gaussianBlurImage.saveASCII(data_path + "Results/gaussian_blur_out.ascii");
+		gaussianBlurImage.saveRaw(data_path + "Results/gaussian_blur_out.raw");
 
 		gaussianBlurImage.getSAE(input_4);
 		std::cout << (std::abs(gaussianBlurImage.getNCC(ref_3) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(gaussianBlurImage.getSAE(ref_3)) << std::endl;
 		
 		Image boxBlurImage;
-		boxBlurImage = input_4.selectFunction_3x3(3);
-		boxBlurImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\box_blur_out.pgm");
-		boxBlurImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\box_blur_out.ascii");
-		boxBlurImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\box_blur_out.raw");
+		boxBlurImage = input_4.selectFunction_3x3(Image::BOX_BLUR);
+		boxBlurImage.savePGM(data_path + "Results/box_blur_out.pgm");
+		boxBlurImage.saveASCII(data_path + "Results/box_blur_out.ascii");
+		boxBlurImage.saveRaw(data_path + "Results/box_blur_out.raw");
 		std::cout << (std::abs(boxBlurImage.getNCC(ref_4) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(boxBlurImage.getSAE(ref_4)) << std::endl;
 
 		Image sharperImage;
-		sharperImage = input_1.selectFunction_3x3(4);
-		sharperImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sharpened_out.pgm");
-		sharperImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sharpened_out.ascii");
-		sharperImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sharpened_out.raw");
+		sharperImage = input_1.selectFunction_3x3(Image::SHARPEN_FILTER);
+		sharperImage.savePGM(data_path + "Results/sharpened_out.pgm");
+		sharperImage.saveASCII(data_path + "Results/sharpened_out.ascii");
+		sharperImage.saveRaw(data_path + "Results/sharpened_out.raw");
 		std::cout << (std::abs(sharperImage.getNCC(ref_5) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(sharperImage.getSAE(ref_5)) << std::endl;
 
 		Image segmentedImage;
 		segmentedImage = input_1.segmentImage(125);
-		segmentedImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\segmented_out.pgm");
-		segmentedImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\segmented_out.ascii");
-		segmentedImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\segmented_out.raw");
+		segmentedImage.savePGM(data_path + "Results/segmented_out.pgm");
+		segmentedImage.saveASCII(data_path + "Results/segmented_out.ascii");
+		segmentedImage.saveRaw(data_path + "Results/segmented_out.raw");
 		std::cout << (std::abs(segmentedImage.getNCC(ref_6) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(segmentedImage.getSAE(ref_6)) << std::endl;
 
 		Image blendedImage; //x
 		blendedImage = input_2.blendImage(input_3, 0.5);
-		blendedImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\blended_out.pgm");
-		blendedImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\blended_out.ascii");
-		blendedImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\blended_out.raw");;
+		blendedImage.savePGM(data_path + "Results/blended_out.pgm");
+		blendedImage.saveASCII(data_path + "Results/blended_out.ascii");
+		blendedImage.saveRaw(data_path + "Results/blended_out.raw");;
 
 		Image prewittImage; //x
-		prewittImage = input_1.selectFunction_3x3(5);
-		prewittImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\prewitt_edgedetection_out.pgm");
-		prewittImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\prewitt_edgedetection_out.ascii");
-		prewittImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\prewitt_edgedetection_out.raw");
+		prewittImage = input_1.selectFunction_3x3(Image::PREWITT_FILTER);
+		prewittImage.savePGM(data_path + "Results/prewitt_edgedetection_out.pgm");
+		prewittImage.saveASCII(data_path + "Results/prewitt_edgedetection_out.ascii");
+		prewittImage.saveRaw(data_path + "Results/prewitt_edgedetection_out.raw");
 		std::cout << (std::abs(prewittImage.getNCC(ref_7) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl;
 		std::cout << abs(prewittImage.getSAE(ref_7)) << std::endl;
 
 		Image sobelImage; //x
-		sobelImage = input_1.selectFunction_3x3(6);
-		sobelImage.savePGM("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sobel_edgedetection_out.pgm");
-		sobelImage.saveASCII("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sobel_edgedetection_out.ascii");
-		sobelImage.saveRaw("C:\\Programs\\C++\\computer vision\\Assignments\\CV Assignment 2\\test_data\\results\\sobel_edgedetection_out.raw");
+		sobelImage = input_1.selectFunction_3x3(Image::SOBEL_FILTER);
+		sobelImage.savePGM(data_path + "Results/sobel_edgedetection_out.pgm");
+		sobelImage.saveASCII(data_path + "Results/sobel_edgedetection_out.ascii");
+		sobelImage.saveRaw(data_path + "Results/sobel_edgedetection_out.raw");
 		//sobelImage.getNCC(input_1);
 		std::cout << (std::abs(sobelImage.getNCC(ref_8) - 1.0) < 1.0e-3 ? "SUCCESS" : "FAILURE") << std::endl; 
 		std::cout << abs(sobelImage.getSAE(ref_8)) << std::endl;
+
+		// The 3x3 filters with every instruction set: the results are the same
+		// as the scalar code, and they match the reference images computed
+		// from the same inputs (median, Laplacian and box blur)
+		const int function_set[] = { Image::MEDIAN_FILTER, Image::LAPLACIAN_FILTER,
+				Image::GAUSSIAN_BLUR, Image::BOX_BLUR, Image::SHARPEN_FILTER,
+				Image::PREWITT_FILTER, Image::SOBEL_FILTER };
+		const char* function_name_set[] = { "median filter", "Laplacian filter",
+				"Gaussian blur", "box blur", "sharpen filter", "Prewitt filter", "Sobel filter" };
+		const Image* p_input_set[] = { &input_4, &input_1, &input_4, &input_4, &input_1, &input_1, &input_1 };
+		const Image* p_reference_set[] = { &ref_1, &ref_2, 0, &ref_4, 0, 0, 0 };
+		const char* instruction_set_name_set[] = { "scalar", "SSE", "AVX2" };
+		const unsigned int function_count(sizeof(function_set) / sizeof(function_set[0]));
+
+		Image scalar_output_set[function_count];
+		const RowKernels::InstructionSet supported_instruction_set(RowKernels::getSupportedInstructionSet());
+		for (int instruction_set(RowKernels::SCALAR); instruction_set <= supported_instruction_set; ++instruction_set)
+		{
+			RowKernels::setInstructionSet(RowKernels::InstructionSet(instruction_set));
+			for (unsigned int k(0); k < function_count; ++k)
+			{
+				const Image output(p_input_set[k]->selectFunction_3x3(function_set[k]));
+				const std::string name(std::string(function_name_set[k]) + " (" +
+						instruction_set_name_set[instruction_set] + ")");
+
+				if (instruction_set == RowKernels::SCALAR)
+				{
+					scalar_output_set[k] = output;
+				}
+				else
+				{
+					printCheck(name + " identical to scalar", output == scalar_output_set[k], error_code);
+				}
+
+				if (p_reference_set[k])
+				{
+					printCheck(name + " matches the reference", isCloseToReference(output, *p_reference_set[k]), error_code);
+				}
+			}
+		}
+		RowKernels::setInstructionSet(supported_instruction_set);
+
+		// The row bands processed by several threads give the same result as a
+		// single thread
+		for (unsigned int k(0); k < function_count; ++k)
+		{
+			Image::setNumberOfThreads(1);
+			const Image serial_output(p_input_set[k]->selectFunction_3x3(function_set[k]));
+			Image::setNumberOfThreads(4);
+			const Image parallel_output(p_input_set[k]->selectFunction_3x3(function_set[k]));
+
+			printCheck(std::string(function_name_set[k]) + " identical with 1 and 4 threads",
+					serial_output == parallel_output, error_code);
+		}
+		Image::setNumberOfThreads(1);
     }
     // An error occured
     catch (const std::exception& error)